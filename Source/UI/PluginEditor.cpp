@@ -7,6 +7,7 @@
 */
 #pragma once
 #include "../audioProcessor/PluginProcessor.h"
+#include "../audioProcessor/scalaTuning.h"
 #include "PluginEditor.h"
 #include "../components/instrumentPresets/PresetListBox.h"
 #include "CustomLookAndFeel.h"
@@ -17,29 +18,18 @@
 #include <algorithm>
 using namespace std;
 
-extern MicrotonalConfig microtonalMappings[7];
-juce::String microtonalPresetNames[7] = { "Default", "1", "2", "3", "4", "5", "6" }, instrumentPresetNames[7] = { "Default", "<Instrument 1>", "<Instrument 2>", "<Instrument 3>", "<Instrument 4>", "<Instrument 5>", "<Instrument 6>" };
-
-
 /*
-*   Instruments work by saving ValueTree representation of your instrument XML file into this array.
-*   Array holds 7 instrument presets at a time
-*   Whenever you swap between instruments, you change the current instrument variable which functions as an index to access the correct instrument
+*   Instruments work by saving ValueTree representation of your instrument XML file into engineContext.loadedInstruments.
+*   The array holds 7 instrument presets at a time
+*   Whenever you swap between instruments, you change engineContext.currentInstrument which functions as an index to access the correct instrument
 */
-int mappingGroup = Default, currentInstrument = 0;
-juce::ValueTree loadedInstruments[7];
 
-MainContentComponent* createMainContentComponent(int index)
-{
-    return new MainContentComponent(index);
-}
-
-MicrotonalWindow::MicrotonalWindow(juce::String name, int index) : DocumentWindow(name,
+MicrotonalWindow::MicrotonalWindow(juce::String name, EngineContext& context, int index) : DocumentWindow(name,
     juce::Colours::dimgrey,
     DocumentWindow::closeButton | DocumentWindow::maximiseButton, true)
 {
     double ratio = 2; // adjust as desired
-    setContentOwned(new MainContentComponent(index), true);
+    setContentOwned(new MainContentComponent(context, index), true);
     getConstrainer()->setFixedAspectRatio(ratio);
     centreWithSize(1300, 600);
     setResizable(true, true);
@@ -64,13 +54,19 @@ juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
     groupInstruments->addChild(std::make_unique<juce::AudioParameterChoice>("instrumentPreset", "Instrument_Preset", juce::StringArray({ "preset342", "preset54" }), 0));
     layout.add(std::move(groupInstruments));
 
+    Synth::addOscillatorLfoParameters(layout);
+    Synth::addEngineParameters(layout);
+    Synth::addTuningParameters(layout);
+
     return layout;
 }
 
 MicrotonalSynthAudioProcessorEditor::MicrotonalSynthAudioProcessorEditor()
     : foleys::MagicProcessor(juce::AudioProcessor::BusesProperties()
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-    treeState(*this, nullptr, ProjectInfo::projectName, createParameterLayout())
+    treeState(*this, nullptr, ProjectInfo::projectName, createParameterLayout()),
+    synthesiser(engineContext),
+    tuningLibrary(TuningLibrary::getShared())
 {
     FOLEYS_SET_SOURCE_PATH(__FILE__);
 
@@ -124,22 +120,22 @@ MicrotonalSynthAudioProcessorEditor::MicrotonalSynthAudioProcessorEditor()
     magicState.addTrigger("open-window5", [this] {if (activeWindow != 5) { delete window; } openWindow(5);});
     magicState.addTrigger("open-window6", [this] {if (activeWindow != 6) { delete window; } openWindow(6);});
 
-    magicState.addTrigger("set-map1", [this] { mappingGroup = mappingGroup == Group1 ? Default : Group1;});
-    magicState.addTrigger("set-map2", [this] {mappingGroup = mappingGroup == Group2 ? Default : Group2;});
-    magicState.addTrigger("set-map3", [this] {mappingGroup = mappingGroup == Group3 ? Default : Group3;});
-    magicState.addTrigger("set-map4", [this] {mappingGroup = mappingGroup == Group4 ? Default : Group4;});
-    magicState.addTrigger("set-map5", [this] {mappingGroup = mappingGroup == Group5 ? Default : Group5;});
-    magicState.addTrigger("set-map6", [this]{mappingGroup = mappingGroup == Group6 ? Default : Group6;});
+    magicState.addTrigger("set-map1", [this] { engineContext.mappingGroup = engineContext.mappingGroup == Group1 ? Default : Group1;});
+    magicState.addTrigger("set-map2", [this] {engineContext.mappingGroup = engineContext.mappingGroup == Group2 ? Default : Group2;});
+    magicState.addTrigger("set-map3", [this] {engineContext.mappingGroup = engineContext.mappingGroup == Group3 ? Default : Group3;});
+    magicState.addTrigger("set-map4", [this] {engineContext.mappingGroup = engineContext.mappingGroup == Group4 ? Default : Group4;});
+    magicState.addTrigger("set-map5", [this] {engineContext.mappingGroup = engineContext.mappingGroup == Group5 ? Default : Group5;});
+    magicState.addTrigger("set-map6", [this]{engineContext.mappingGroup = engineContext.mappingGroup == Group6 ? Default : Group6;});
     /* END onClick methods*/
     magicState.setApplicationSettingsFile(juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
         .getChildFile(ProjectInfo::companyName)
         .getChildFile(ProjectInfo::projectName + juce::String(".settings")));
     magicState.setPlayheadUpdateFrequency(30);
 
-    Synth::Sound::Ptr sound(new Synth::Sound(treeState));
+    synthesiser.attachParameters(treeState);
+    Synth::Sound::Ptr sound(new Synth::Sound());
     synthesiser.addSound(sound);
-    for (int i = 0; i < 16; ++i)
-        synthesiser.addVoice(new Synth::Voice(treeState));
+    synthesiser.setTuningLibrary(tuningLibrary);
 }
 
 
@@ -163,12 +159,12 @@ void MicrotonalSynthAudioProcessorEditor::prepareToPlay(double sampleRate, int b
 void MicrotonalSynthAudioProcessorEditor::openWindow(int index)
 {
     if (!window) {
-        window = new MicrotonalWindow("Configure Microtonal Mapping Preset " + to_string(index), index);
+        window = new MicrotonalWindow("Configure Microtonal Mapping Preset " + to_string(index), engineContext, index);
         activeWindow = index;
     }
     else if (index != activeWindow) {
         delete window;
-        new MicrotonalWindow("Configure Microtonal Mapping Preset " + to_string(index), index);
+        new MicrotonalWindow("Configure Microtonal Mapping Preset " + to_string(index), engineContext, index);
     }
 }
 
@@ -188,6 +184,7 @@ bool MicrotonalSynthAudioProcessorEditor::isBusesLayoutSupported(const juce::Aud
 void MicrotonalSynthAudioProcessorEditor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    const auto blockStart = juce::Time::getMillisecondCounterHiRes();
 
     // MAGIC GUI: send midi messages to the keyboard state and MidiLearn
     magicState.processMidiBuffer(midiMessages, buffer.getNumSamples(), true);
@@ -195,7 +192,31 @@ void MicrotonalSynthAudioProcessorEditor::processBlock(juce::AudioBuffer<float>&
     // MAGIC GUI: send playhead information to the GUI
     magicState.updatePlayheadInformation(getPlayHead());
 
-    synthesiser.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    synthesiser.updateTransport(getPlayHead());
+    synthesiser.setNonRealtime(isNonRealtime());
+    synthesiser.updateParameters(buffer.getNumSamples());
+    synthesiser.updateTuning();
+
+    // nothing ringing and nothing to start: skip rendering, and meter only the first silent block
+    if (midiMessages.isEmpty() && synthesiser.isIdle())
+    {
+        buffer.clear();
+        synthesiser.skipIdleBlock(buffer.getNumSamples());
+
+        if (!outputIdle)
+        {
+            outputMeter->pushSamples(buffer);
+            oscilloscope->pushSamples(buffer);
+            analyser->pushSamples(buffer);
+            outputIdle = true;
+        }
+
+        synthesiser.registerBlockTime(juce::Time::getMillisecondCounterHiRes() - blockStart, buffer.getNumSamples());
+        return;
+    }
+
+    outputIdle = false;
+    synthesiser.render(buffer, midiMessages, 0, buffer.getNumSamples());
 	
     for (int i = 1; i < buffer.getNumChannels(); ++i)
         buffer.copyFrom(i, 0, buffer.getReadPointer(0), buffer.getNumSamples());
@@ -204,6 +225,8 @@ void MicrotonalSynthAudioProcessorEditor::processBlock(juce::AudioBuffer<float>&
     outputMeter->pushSamples(buffer);
     oscilloscope->pushSamples(buffer);
     analyser->pushSamples(buffer);
+
+    synthesiser.registerBlockTime(juce::Time::getMillisecondCounterHiRes() - blockStart, buffer.getNumSamples());
 }
 
 //==============================================================================
@@ -243,7 +266,7 @@ void MicrotonalSynthAudioProcessorEditor::savePresetInternal()
 
  void MicrotonalSynthAudioProcessorEditor::loadHelper(int swapTo)
 {
-     if (!loadedInstruments[swapTo].isValid())
+     if (!engineContext.loadedInstruments[swapTo].isValid())
      {
          DBG("INVALID INSTRUMENT");
          return;
@@ -253,10 +276,10 @@ void MicrotonalSynthAudioProcessorEditor::savePresetInternal()
     foleys::ParameterManager manager(*this);
 
     // Sets the index of the instrumentArray to be the selected instrument
-    currentInstrument = swapTo;
+    engineContext.currentInstrument = swapTo;
 
     // Load the desired instrument into state
-    manager.loadParameterValues(loadedInstruments[currentInstrument]);
+    manager.loadParameterValues(engineContext.loadedInstruments[engineContext.currentInstrument]);
 }
 
 void MicrotonalSynthAudioProcessorEditor::loadPresetInternal(int index)
@@ -272,14 +295,14 @@ void MicrotonalSynthAudioProcessorEditor::loadPresetInternal(int index)
 
         myFile = fc.getResult();
         juce::String fileName = myFile.getFileName();
-        instrumentPresetNames[index] = fileName;
+        engineContext.instrumentPresetNames[index] = fileName;
 
         juce::XmlDocument doc(myFile.loadFileAsString());
         juce::XmlElement config = *doc.getDocumentElement();
         juce::ValueTree instrument;
         instrument = instrument.fromXml(config);
 
-        loadedInstruments[index] = instrument;
+        engineContext.loadedInstruments[index] = instrument;
 
         });
 }
@@ -303,7 +326,7 @@ class InstrumentPresetComponent : public juce::Component, private juce::Timer, p
 {
 public:
     //==============================================================================
-    InstrumentPresetComponent() {
+    InstrumentPresetComponent(const EngineContext& contextToShow) : context(contextToShow) {
         for (int i = 0; i < 6; i++) {
             addAndMakeVisible(btns[i]);
             /*btns[i].setTooltip(instrumentPresetNames[i + 1]);*/
@@ -329,18 +352,18 @@ public:
     }
     void paint(juce::Graphics& g) override {
         for (int i = 0; i < 6; i++) {
-            if (i + 1 == currentInstrument && loadedInstruments[currentInstrument].isValid() ) {
+            if (i + 1 == context.currentInstrument && context.loadedInstruments[context.currentInstrument].isValid() ) {
                 btns[i].setColour(juce::TextButton::buttonColourId, juce::Colours::darkgreen);
             }
-            else if (i + 1 != currentInstrument && loadedInstruments[i + 1].isValid()) {
+            else if (i + 1 != context.currentInstrument && context.loadedInstruments[i + 1].isValid()) {
                 btns[i].setColour(juce::TextButton::buttonColourId, juce::Colours::blue);
             }
             else {
                 btns[i].setColour(juce::TextButton::buttonColourId, juce::Colours::grey);
             }
-            btns[i].setButtonText(instrumentPresetNames[i + 1].contains(".xml") ? instrumentPresetNames[i + 1].substring(0, instrumentPresetNames[i + 1].indexOf(".")) : instrumentPresetNames[i + 1]);
-            if (instrumentPresetNames[i + 1].contains(".xml")) {
-                btns[i].setTooltip(instrumentPresetNames[i + 1].substring(0, instrumentPresetNames[i + 1].indexOf(".")));
+            btns[i].setButtonText(context.instrumentPresetNames[i + 1].contains(".xml") ? context.instrumentPresetNames[i + 1].substring(0, context.instrumentPresetNames[i + 1].indexOf(".")) : context.instrumentPresetNames[i + 1]);
+            if (context.instrumentPresetNames[i + 1].contains(".xml")) {
+                btns[i].setTooltip(context.instrumentPresetNames[i + 1].substring(0, context.instrumentPresetNames[i + 1].indexOf(".")));
             }
 
         }
@@ -350,6 +373,7 @@ public:
 
     }
 private:
+    const EngineContext& context;
     juce::TextButton btns[6];
     void timerCallback() override
     {
@@ -368,9 +392,8 @@ private:
 class InstrumentPresetComponentItem : public foleys::GuiItem
 {
 public:
-    FOLEYS_DECLARE_GUI_FACTORY(InstrumentPresetComponentItem)
-
-        InstrumentPresetComponentItem(foleys::MagicGUIBuilder& builder, const juce::ValueTree& node) : foleys::GuiItem(builder, node)
+    InstrumentPresetComponentItem(foleys::MagicGUIBuilder& builder, const juce::ValueTree& node, const EngineContext& context)
+        : foleys::GuiItem(builder, node), activeInstrumentComponent(context)
     {
         addAndMakeVisible(activeInstrumentComponent);
     }
@@ -393,14 +416,14 @@ private:
 };
 
 /* A clickable component that visualizes mapped, active, and empty presets */
-class ActivePresetComponent : public juce::Component, private juce::Timer, public juce::Button::Listener, public MicrotonalSynthAudioProcessorEditor
+class ActivePresetComponent : public juce::Component, private juce::Timer, public juce::Button::Listener
 {
 public:
     /* Constructor that renders and activates the buttons for active preset */
-    ActivePresetComponent(){
+    ActivePresetComponent(EngineContext& contextToShow) : context(contextToShow) {
         for (int i = 0; i < 6; i++) {
             addAndMakeVisible(btns[i]);
-            btns[i].setButtonText(microtonalPresetNames[i+1]);
+            btns[i].setButtonText(context.microtonalPresetNames[i+1]);
             //btns[i].setEnabled(false);
             btns[i].addListener(this);
             btns[i].setMouseCursor(juce::MouseCursor::PointingHandCursor);
@@ -436,12 +459,12 @@ public:
     void paint(juce::Graphics& g) override{
         /* Changes the color of the preset based on if it is active-mapped, empty, inactive-mapped */
         for (int i = 0; i < 6; i++) {
-            if (i+1 == mappingGroup) {
+            if (i+1 == context.mappingGroup) {
                 btns[i].setColour(juce::TextButton::buttonColourId, juce::Colours::darkgreen);
             } 
-            else if (microtonalMappings[i + 1].isMapped()) {
+            else if (context.isMapped(i + 1)) {
                 btns[i].setColour(juce::TextButton::buttonColourId, juce::Colours::blue);
-                btns[i].setButtonText(microtonalPresetNames[i + 1].contains(".xml") ? microtonalPresetNames[i + 1].substring(0, microtonalPresetNames[i + 1].indexOf(".")) : microtonalPresetNames[i + 1]);
+                btns[i].setButtonText(context.microtonalPresetNames[i + 1].contains(".xml") ? context.microtonalPresetNames[i + 1].substring(0, context.microtonalPresetNames[i + 1].indexOf(".")) : context.microtonalPresetNames[i + 1]);
             }
             else {
                 btns[i].setColour(juce::TextButton::buttonColourId, juce::Colours::grey);
@@ -459,12 +482,13 @@ public:
     void buttonClicked(juce::Button* btn) override{
         for (int i = 0; i < 6; i++) {
             if (btn == &btns[i]) {
-                mappingGroup = mappingGroup == i + 1 ? Default : i + 1;
+                context.mappingGroup = context.mappingGroup == i + 1 ? Default : i + 1;
             }
 
         }
     }
 private:
+    EngineContext& context;
     juce::TextButton btns[6];
     /* Function to update the state of the application on a timer */
     void timerCallback() override
@@ -488,9 +512,8 @@ private:
 class ActivePresetComponentItem : public foleys::GuiItem
 {
 public:
-    FOLEYS_DECLARE_GUI_FACTORY(ActivePresetComponentItem)
-
-    ActivePresetComponentItem(foleys::MagicGUIBuilder& builder, const juce::ValueTree& node) : foleys::GuiItem(builder, node)
+    ActivePresetComponentItem(foleys::MagicGUIBuilder& builder, const juce::ValueTree& node, EngineContext& context)
+        : foleys::GuiItem(builder, node), activepresetcomponent(context)
     {
         addAndMakeVisible(activepresetcomponent);
     }
@@ -519,14 +542,19 @@ void MicrotonalSynthAudioProcessorEditor::initialiseBuilder(foleys::MagicGUIBuil
     builder.registerLookAndFeel("Save", make_unique<customSave>());
     builder.registerLookAndFeel("Load", make_unique<customLoad>());
     builder.registerLookAndFeel("Power", make_unique<customPower>());
-    builder.registerFactory("ActivePresetComponent", &ActivePresetComponentItem::factory);
-    builder.registerFactory("InstrumentPresetComponent", &InstrumentPresetComponentItem::factory);
+    // the items show this instance's presets, so their factories capture its EngineContext
+    builder.registerFactory("ActivePresetComponent", [this](foleys::MagicGUIBuilder& b, const juce::ValueTree& node) {
+        return std::make_unique<ActivePresetComponentItem>(b, node, engineContext);
+    });
+    builder.registerFactory("InstrumentPresetComponent", [this](foleys::MagicGUIBuilder& b, const juce::ValueTree& node) {
+        return std::make_unique<InstrumentPresetComponentItem>(b, node, engineContext);
+    });
     //DBG(builder.getGuiRootNode().toXmlString());
 }
 
 void MicrotonalSynthAudioProcessorEditor::loadMicrotonalPreset(int preset) {
     // choose a file
-    chooser = std::make_unique<juce::FileChooser>("Load a microtonal mapping preset", juce::File::getSpecialLocation(juce::File::hostApplicationPath).getParentDirectory(), "*.xml", true, true);
+    chooser = std::make_unique<juce::FileChooser>("Load a microtonal mapping preset or Scala scale", juce::File::getSpecialLocation(juce::File::hostApplicationPath).getParentDirectory(), "*.xml;*.scl", true, true);
     auto flags = juce::FileBrowserComponent::openMode
         | juce::FileBrowserComponent::canSelectFiles;
     chooser->launchAsync(flags, [this, preset] (const juce::FileChooser& fc) {
@@ -535,20 +563,50 @@ void MicrotonalSynthAudioProcessorEditor::loadMicrotonalPreset(int preset) {
         juce::File myFile;
 
         myFile = fc.getResult();	
+
+        /* Scala scales go through the tuning library, which reuses its cached table if the file hasn't changed */
+        if (myFile.hasFileExtension("scl")) {
+            juce::String error;
+            if (auto tuning = tuningLibrary->load(myFile, error)) {
+                engineContext.importedTunings[preset] = tuning;
+                engineContext.microtonalPresetNames[preset] = myFile.getFileNameWithoutExtension();
+            }
+            else {
+                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, TRANS("Couldn't load tuning"), error);
+            }
+            return;
+        }
+
         juce::String fileName = myFile.getFileName();
-        microtonalPresetNames[preset] = fileName;
+        engineContext.microtonalPresetNames[preset] = fileName;
+        engineContext.importedTunings[preset].reset();
 
         juce::XmlDocument doc(myFile.loadFileAsString());
         juce::XmlElement config = *doc.getDocumentElement();
         juce::ValueTree t;
         t = t.fromXml(config);
         if (t.isValid()) {
-            microtonalMappings[preset].base_frequency = stod(t.getProperty("base_frequency").toString().toStdString());
-            microtonalMappings[preset].divisions = stod(t.getProperty("total_divisions").toString().toStdString());
+            engineContext.microtonalMappings[preset].base_frequency = stod(t.getProperty("base_frequency").toString().toStdString());
+            engineContext.microtonalMappings[preset].divisions = stod(t.getProperty("total_divisions").toString().toStdString());
+            engineContext.microtonalMappings[preset].spanKeyboard = t.getProperty("span_keyboard", false);
+            engineContext.microtonalMappings[preset].period = t.getProperty("period", "2").toString().getDoubleValue();
+            engineContext.microtonalMappings[preset].scale.clear();
+
+            /* A scale of ratios or cents replaces the equal divisions, and its last pitch sets the period */
+            const juce::String scale = t.getProperty("scale").toString();
+            juce::String error;
+            if (scale.isNotEmpty()) {
+                if (ScalaTuning::parsePitchList(scale, engineContext.microtonalMappings[preset].scale, engineContext.microtonalMappings[preset].period, error))
+                    engineContext.microtonalMappings[preset].divisions = (double)engineContext.microtonalMappings[preset].scale.size() + 1;
+                else
+                    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, TRANS("Couldn't read scale"), error);
+            }
+            if (!(engineContext.microtonalMappings[preset].period > 1.0))
+                engineContext.microtonalMappings[preset].period = 2.0;
             int i = 0;
             for (juce::ValueTree frequency : t) {
-                microtonalMappings[preset].frequencies[i].index = stoi(frequency.getProperty("index").toString().toStdString());
-                microtonalMappings[preset].frequencies[i].frequency = stod(frequency.getProperty("value").toString().toStdString());
+                engineContext.microtonalMappings[preset].frequencies[i].index = stoi(frequency.getProperty("index").toString().toStdString());
+                engineContext.microtonalMappings[preset].frequencies[i].frequency = stod(frequency.getProperty("value").toString().toStdString());
                 i++;
             }
         }
@@ -28,11 +28,10 @@ enum SelectMappingGroup {
     Group6 = 6,
     Default = 0
 };
-extern int mappingGroup;
 class MicrotonalWindow : public juce::DocumentWindow
 {
 public:
-    MicrotonalWindow(juce::String name, int index);
+    MicrotonalWindow(juce::String name, EngineContext& context, int index);
     void closeButtonPressed() override;
 
     //   void resized() override;
@@ -85,7 +84,9 @@ private:
     juce::AudioProcessorValueTreeState treeState;
     juce::Component::SafePointer<MicrotonalWindow> window;
     int activeWindow = Default;
+    EngineContext engineContext;  // this instance's mappings and instruments; must be declared before synthesiser
     Synth      synthesiser;
+    std::shared_ptr<TuningLibrary> tuningLibrary;
     juce::ValueTree  presetNode, microtonalNode;
     //juce::Array<juce::File> instrumentList;
     std::unique_ptr<juce::FileChooser> chooser;
@@ -94,6 +95,7 @@ private:
     foleys::MagicLevelSource* outputMeter = nullptr;
     foleys::MagicPlotSource* oscilloscope = nullptr;
     foleys::MagicPlotSource* analyser = nullptr;
+    bool outputIdle = false;
     juce::File presetDirectory;
 
     PresetListBox* presetList = nullptr;
@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    adaptiveTuning.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "adaptiveTuning.h"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // 7-limit ratios within the octave; 2/1 catches intervals just short of an octave
+    constexpr int justRatios[][2] = { { 1, 1 }, { 16, 15 }, { 10, 9 }, { 9, 8 }, { 7, 6 }, { 6, 5 }, { 5, 4 }, { 4, 3 }, { 7, 5 },
+                                      { 10, 7 }, { 3, 2 }, { 8, 5 }, { 5, 3 }, { 7, 4 }, { 16, 9 }, { 9, 5 }, { 15, 8 }, { 2, 1 } };
+
+    // what an interval with no just ratio near it adds to a candidate root's score
+    constexpr double unmatchedComplexity = 12.0;
+
+    double foldIntoOctave(double cents)
+    {
+        const auto folded = std::fmod(cents, 1200.0);
+        return folded < 0.0 ? folded + 1200.0 : folded;
+    }
+}
+
+AdaptiveTuning::AdaptiveTuning()
+{
+    for (int cent = 0; cent < centsPerOctave; ++cent)
+    {
+        auto nearest = std::numeric_limits<double>::max();
+        for (const auto& ratio : justRatios)
+        {
+            const auto cents = 1200.0 * std::log2((double) ratio[0] / ratio[1]);
+            const auto distance = std::abs(cents - (cent + 0.5));
+            if (distance < nearest)
+            {
+                nearest = distance;
+                ratios[(size_t) cent] = { cents, std::log2((double) ratio[0] * ratio[1]) };
+            }
+        }
+    }
+}
+
+const AdaptiveTuning::Ratio& AdaptiveTuning::getRatio(double intervalCents) const
+{
+    return ratios[(size_t) juce::jlimit(0, centsPerOctave - 1, (int) foldIntoOctave(intervalCents))];
+}
+
+double AdaptiveTuning::getDeviation(double intervalCents) const
+{
+    return getRatio(intervalCents).cents - foldIntoOctave(intervalCents);
+}
+
+void AdaptiveTuning::analyse(const double* frequencies, int count, double* offsets) const
+{
+    jassert(count <= maxNotes);
+    count = juce::jmin(count, maxNotes);
+
+    for (int i = 0; i < count; ++i)
+        offsets[i] = 0.0;
+
+    if (count < 2)
+        return;
+
+    double cents[maxNotes];
+    for (int i = 0; i < count; ++i)
+        cents[i] = 1200.0 * std::log2(frequencies[i]);
+
+    // the root is the note the others are the simplest ratios above; ties go to the lowest
+    auto root = 0;
+    auto bestScore = std::numeric_limits<double>::max();
+    for (int candidate = 0; candidate < count; ++candidate)
+    {
+        auto score = 0.0;
+        for (int i = 0; i < count; ++i)
+        {
+            if (i == candidate)
+                continue;
+
+            const auto interval = cents[i] - cents[candidate];
+            const auto& ratio = getRatio(interval);
+            score += std::abs(ratio.cents - foldIntoOctave(interval)) <= settings.toleranceCents ? ratio.complexity
+                                                                                                 : unmatchedComplexity;
+        }
+
+        if (score < bestScore || (score == bestScore && cents[candidate] < cents[root]))
+        {
+            bestScore = score;
+            root = candidate;
+        }
+    }
+
+    auto sum = 0.0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (i == root)
+            continue;
+
+        const auto deviation = getDeviation(cents[i] - cents[root]);
+        offsets[i] = std::abs(deviation) <= settings.toleranceCents ? deviation : 0.0;
+        sum += offsets[i];
+    }
+
+    const auto shift = settings.anchor == Anchor::mean ? sum / count : 0.0;
+    for (int i = 0; i < count; ++i)
+        offsets[i] = juce::jlimit(-settings.maxDriftCents, settings.maxDriftCents, offsets[i] - shift) / 100.0;
+}
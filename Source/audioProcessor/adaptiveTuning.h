@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    adaptiveTuning.h
+    Created: 16 Oct 2026
+
+    Adaptive just intonation: given the notes being held, finds the one
+    that makes the chord simplest as a root and offsets the others towards
+    pure ratios from it. Intervals are looked up in a table, built once,
+    of the nearest just ratio to every cent of the octave, so analysing a
+    chord of n notes is n logarithms and n * n table reads. The offsets
+    stay anchored to the underlying tuning: they are centred on the root
+    or on the chord's average and never move a note further than the
+    drift limit from its key.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include <array>
+
+class AdaptiveTuning
+{
+public:
+    static constexpr int maxNotes = 256;
+
+    enum class Anchor
+    {
+        root,  // the root keeps its key's pitch
+        mean   // the chord's average pitch stays where the keys put it
+    };
+
+    struct Settings
+    {
+        double maxDriftCents = 20.0;   // furthest any note moves from its key
+        double toleranceCents = 30.0;  // intervals further than this from a just ratio are left alone
+        Anchor anchor = Anchor::mean;
+    };
+
+    AdaptiveTuning();
+
+    void setSettings(const Settings& newSettings) { settings = newSettings; }
+    const Settings& getSettings() const { return settings; }
+
+    /* Writes the offset in semitones for each of count notes at frequencies, all of them
+       greater than 0. Count may be at most maxNotes. Doesn't allocate */
+    void analyse(const double* frequencies, int count, double* offsets) const;
+
+private:
+    static constexpr int centsPerOctave = 1200;
+
+    /* The just ratio nearest an interval, folded into one octave */
+    struct Ratio
+    {
+        double cents = 0.0;
+        double complexity = 0.0;  // Tenney height, log2(numerator * denominator)
+    };
+
+    const Ratio& getRatio(double intervalCents) const;
+    /* The interval's distance from its nearest just ratio, in cents */
+    double getDeviation(double intervalCents) const;
+
+    std::array<Ratio, centsPerOctave> ratios;
+    Settings                          settings;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AdaptiveTuning)
+};
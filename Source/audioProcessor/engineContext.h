@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    engineContext.h
+    Created: 16 Oct 2026
+
+    Everything one plugin instance can change about its tuning and loaded
+    instruments: the seven microtonal mappings or the Scala tunings
+    imported over them, which one is active, the instrument presets and
+    the names shown for both. The processor owns
+    one and hands it to the Synth and the GUI, so instances in the same
+    host process never share mutable state. Read-only data that really is
+    common, like the WavetableBank, stays in its own shared cache.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "../components/microtonal/Microtonal.h"
+#include "tuningLibrary.h"
+
+struct EngineContext
+{
+    static constexpr int numPresets = 7;
+
+    MicrotonalConfig microtonalMappings[numPresets];
+    std::atomic<int> mappingGroup { 0 };  // 0 is the unmapped default
+    juce::String     microtonalPresetNames[numPresets] = { "Default", "1", "2", "3", "4", "5", "6" };
+    /* A Scala tuning loaded into a preset; when set it is played instead of that preset's mapping */
+    std::shared_ptr<const CompiledTuning> importedTunings[numPresets];
+
+    /* ValueTree of each loaded instrument file; currentInstrument indexes the one in use */
+    juce::ValueTree  loadedInstruments[numPresets];
+    int              currentInstrument = 0;
+    juce::String     instrumentPresetNames[numPresets] = { "Default", "<Instrument 1>", "<Instrument 2>", "<Instrument 3>",
+                                                           "<Instrument 4>", "<Instrument 5>", "<Instrument 6>" };
+
+    bool isMapped(int preset) { return importedTunings[preset] != nullptr || microtonalMappings[preset].isMapped(); }
+};
@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    envelopeGenerator.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "envelopeGenerator.h"
+
+void EnvelopeGenerator::setSampleRate(double newSampleRate)
+{
+    jassert(newSampleRate > 0.0);
+    sampleRate = newSampleRate;
+}
+
+void EnvelopeGenerator::setParameters(const Parameters& newParameters)
+{
+    if (newParameters == parameters)
+        return;
+
+    const auto sustainChanged = newParameters.sustain != parameters.sustain;
+    parameters = newParameters;
+
+    switch (stage)
+    {
+        case Stage::attack:
+        case Stage::decay:
+        case Stage::release:
+            startStage(stage);
+            break;
+
+        case Stage::sustain:
+            // glide to the new level at the decay rate instead of jumping
+            if (sustainChanged)
+                startStage(Stage::decay);
+            break;
+
+        case Stage::idle:
+            break;
+    }
+}
+
+void EnvelopeGenerator::setCurve(Curve newCurve)
+{
+    if (newCurve == curve)
+        return;
+
+    curve = newCurve;
+    if (stage == Stage::attack || stage == Stage::decay || stage == Stage::release)
+        startStage(stage);
+}
+
+void EnvelopeGenerator::noteOn()
+{
+    startStage(Stage::attack);
+}
+
+void EnvelopeGenerator::noteOff()
+{
+    if (stage != Stage::idle)
+        startStage(Stage::release);
+}
+
+void EnvelopeGenerator::reset()
+{
+    startStage(Stage::idle);
+}
+
+void EnvelopeGenerator::startStage(Stage newStage)
+{
+    stage = newStage;
+
+    switch (stage)
+    {
+        case Stage::attack:
+            if (parameters.attack > 0.0f && level < 1.0f)
+            {
+                startSegment(1.0f, parameters.attack * (1.0 - level), attackOvershoot);
+                return;
+            }
+
+            level = 1.0f;
+            startStage(Stage::decay);
+            return;
+
+        case Stage::decay:
+        {
+            const auto range = 1.0f - parameters.sustain;
+            if (parameters.decay > 0.0f && range > 0.0f && level != parameters.sustain)
+            {
+                startSegment(parameters.sustain, parameters.decay * std::abs(level - parameters.sustain) / range, decayOvershoot);
+                return;
+            }
+
+            startStage(Stage::sustain);
+            return;
+        }
+
+        case Stage::release:
+            if (parameters.release > 0.0f && level > 0.0f)
+            {
+                startSegment(0.0f, parameters.release, decayOvershoot);
+                return;
+            }
+
+            startStage(Stage::idle);
+            return;
+
+        case Stage::sustain:
+            level = parameters.sustain;
+            break;
+
+        case Stage::idle:
+            level = 0.0f;
+            break;
+    }
+
+    target = level;
+    multiplier = 1.0f;
+    offset = 0.0f;
+    samplesLeft = hold;
+}
+
+void EnvelopeGenerator::startSegment(float newTarget, double durationSeconds, float overshoot)
+{
+    target = newTarget;
+    samplesLeft = juce::jmax(1, juce::roundToInt(durationSeconds * sampleRate));
+
+    if (curve == Curve::linear)
+    {
+        multiplier = 1.0f;
+        offset = (target - level) / float(samplesLeft);
+    }
+    else
+    {
+        // one-pole approach to a point just past the target, timed to cross it on the last sample
+        const auto distance = std::abs(target - level);
+        const auto aim = target + (target > level ? overshoot : -overshoot);
+        multiplier = (float) std::pow(overshoot / (distance + overshoot), 1.0 / samplesLeft);
+        offset = aim * (1.0f - multiplier);
+    }
+}
+
+void EnvelopeGenerator::finishStage()
+{
+    switch (stage)
+    {
+        case Stage::attack:
+            level = target;
+            startStage(Stage::decay);
+            break;
+
+        case Stage::decay:
+            startStage(Stage::sustain);
+            break;
+
+        case Stage::release:
+            startStage(Stage::idle);
+            break;
+
+        case Stage::sustain:
+        case Stage::idle:
+            samplesLeft = hold;
+            break;
+    }
+}
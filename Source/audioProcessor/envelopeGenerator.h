@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    envelopeGenerator.h
+    Created: 16 Oct 2026
+
+    ADSR built from segments. Each segment's slope is worked out once when
+    it starts, so a sample costs one multiply-add whatever the curve, and a
+    whole block of levels can be written at once. Follows juce::ADSR: attack
+    and decay rates are fixed by their times, release runs from wherever
+    the level is. Used for the voice envelope and for every oscillator's
+    own attackA/decayA/sustainA/releaseA envelope.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include <limits>
+
+class EnvelopeGenerator
+{
+public:
+    enum class Curve { linear, exponential };
+
+    /* Times in seconds, sustain as a level */
+    struct Parameters
+    {
+        float attack = 0.1f;
+        float decay = 0.1f;
+        float sustain = 1.0f;
+        float release = 0.1f;
+
+        bool operator== (const Parameters& other) const
+        {
+            return attack == other.attack && decay == other.decay
+                && sustain == other.sustain && release == other.release;
+        }
+        bool operator!= (const Parameters& other) const { return !(*this == other); }
+    };
+
+    EnvelopeGenerator() = default;
+
+    void setSampleRate(double newSampleRate);
+    /* Cheap when nothing changed; otherwise the running segment restarts from the current level */
+    void setParameters(const Parameters& newParameters);
+    void setCurve(Curve newCurve);
+
+    void noteOn();
+    void noteOff();
+    void reset();
+
+    bool  isActive() const { return stage != Stage::idle; }
+    bool  isAttacking() const { return stage == Stage::attack; }
+    bool  isReleasing() const { return stage == Stage::release; }
+    float getLevel() const { return level; }
+
+    float getNextSample()
+    {
+        level = level * multiplier + offset;
+        if (--samplesLeft == 0)
+            finishStage();
+
+        return level;
+    }
+
+    /* Writes the next numSamples levels */
+    void render(float* levels, int numSamples) { process<true>(levels, numSamples); }
+    /* Advances numSamples and returns the level reached */
+    float skip(int numSamples) { process<false>(nullptr, numSamples); return level; }
+
+private:
+    enum class Stage { idle, attack, decay, sustain, release };
+
+    static constexpr int   hold = std::numeric_limits<int>::max();
+    static constexpr float attackOvershoot = 0.3f;
+    static constexpr float decayOvershoot = 0.001f;
+
+    void startStage(Stage newStage);
+    void startSegment(float target, double durationSeconds, float overshoot);
+    void finishStage();
+
+    template <bool writeLevels>
+    void process(float* levels, int numSamples)
+    {
+        while (numSamples > 0)
+        {
+            const auto todo = juce::jmin(numSamples, samplesLeft);
+            const auto m = multiplier, o = offset;
+            auto l = level;
+
+            for (int i = 0; i < todo; ++i)
+            {
+                l = l * m + o;
+                if constexpr (writeLevels)
+                    levels[i] = l;
+            }
+
+            level = l;
+            numSamples -= todo;
+            if constexpr (writeLevels)
+                levels += todo;
+
+            if ((samplesLeft -= todo) == 0)
+                finishStage();
+        }
+    }
+
+    Parameters parameters;
+    Curve      curve = Curve::linear;
+    double     sampleRate = 44100.0;
+    Stage      stage = Stage::idle;
+    float      level = 0.0f;
+    float      target = 0.0f;
+    float      multiplier = 1.0f;
+    float      offset = 0.0f;
+    int        samplesLeft = hold;
+
+    JUCE_LEAK_DETECTOR(EnvelopeGenerator)
+};
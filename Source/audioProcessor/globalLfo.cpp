@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    globalLfo.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "globalLfo.h"
+#include <cmath>
+
+namespace
+{
+    struct SyncDivision
+    {
+        const char* name;
+        double      beats;
+    };
+
+    // note lengths as a fraction of a bar of 4/4, measured in quarter notes
+    const SyncDivision syncDivisions[] = {
+        { "Free", 0.0 },
+        { "4/1",  16.0 },
+        { "2/1",  8.0 },
+        { "1/1",  4.0 },
+        { "1/2",  2.0 },
+        { "1/4",  1.0 },
+        { "1/8",  0.5 },
+        { "1/16", 0.25 },
+        { "1/32", 0.125 }
+    };
+}
+
+GlobalLfo::GlobalLfo(const ParameterSnapshot& parametersToUse, const WavetableBank& wavetablesToUse, int maximumBlockSize)
+    : parameters(parametersToUse), wavetables(wavetablesToUse)
+{
+    modulation.setSize(ParameterSnapshot::maxOscillators, maximumBlockSize);
+}
+
+juce::StringArray GlobalLfo::getSyncNames()
+{
+    juce::StringArray names;
+    for (auto& division : syncDivisions)
+        names.add(division.name);
+    return names;
+}
+
+double GlobalLfo::getBeatsPerCycle(int sync)
+{
+    return juce::isPositiveAndBelow(sync, (int) juce::numElementsInArray(syncDivisions))
+        ? syncDivisions[sync].beats
+        : 0.0;
+}
+
+void GlobalLfo::setSampleRate(double newSampleRate)
+{
+    jassert(newSampleRate > 0.0);
+    sampleRate = newSampleRate;
+}
+
+void GlobalLfo::startBlock(double ppqPosition, bool transportRunning)
+{
+    for (int i = 0; i < ParameterSnapshot::maxOscillators; ++i)
+    {
+        auto& osc = parameters.oscillators[i];
+        phaseDeltas[i] = PhaseAccumulator::getIncrement(osc.lfoFrequency, sampleRate);
+
+        const auto beats = getBeatsPerCycle(osc.lfoSync);
+        if (osc.lfoGlobal && transportRunning && beats > 0.0)
+        {
+            auto cycles = ppqPosition / beats;
+            cycles -= std::floor(cycles);
+            phases[i] = juce::uint32(juce::uint64(cycles * PhaseAccumulator::cycle) & 0xffffffff);
+        }
+    }
+}
+
+void GlobalLfo::render(int numSamples, int controlInterval)
+{
+    jassert(numSamples <= modulation.getNumSamples());
+
+    for (int i = 0; i < ParameterSnapshot::maxOscillators; ++i)
+    {
+        auto& osc = parameters.oscillators[i];
+        OscillatorKernels::State state;
+        state.numSamples = numSamples;
+        state.lfoDepth = osc.gainA;
+        state.phaseA = phases[i];
+        state.phaseDeltaA = phaseDeltas[i];
+        state.lfoTable = osc.lfoGlobal && osc.gainA != 0.0f
+            ? wavetables.getTable(osc.waveFormA, phaseDeltas[i])
+            : nullptr;
+
+        active[i] = state.lfoTable != nullptr;
+
+        // unused slots keep running too, so switching one to Global does not restart it
+        if (active[i])
+            OscillatorKernels::renderModulation(state, modulation.getWritePointer(i), controlInterval);
+        else
+            state.phaseA += state.phaseDeltaA * juce::uint32(numSamples);
+
+        phases[i] = state.phaseA;
+    }
+}
+
+void GlobalLfo::skip(int numSamples)
+{
+    for (int i = 0; i < ParameterSnapshot::maxOscillators; ++i)
+    {
+        phases[i] += phaseDeltas[i] * juce::uint32(numSamples);
+        active[i] = false;
+    }
+}
@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    globalLfo.h
+    Created: 16 Oct 2026
+
+    Free-running amplitude LFOs, one per oscillator slot, for slots whose
+    lfoModeA is Global. Synth renders each one once per internal block and
+    every sounding voice multiplies the same buffer into that oscillator,
+    so ensemble patches wobble in phase and pay for one LFO, not sixteen.
+    With lfoSyncA set, the rate follows the host tempo and the phase is
+    locked to the song position while the transport runs.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "oscillatorKernels.h"
+#include "parameterSnapshot.h"
+
+class GlobalLfo
+{
+public:
+    GlobalLfo(const ParameterSnapshot& parameters, const WavetableBank& wavetables, int maximumBlockSize);
+
+    /* Choices for the lfoSyncA parameters; the first is free-running at detuneA Hz */
+    static juce::StringArray getSyncNames();
+    /* Length of one cycle in quarter notes for a lfoSyncA index, or 0 when free-running */
+    static double getBeatsPerCycle(int sync);
+
+    void setSampleRate(double newSampleRate);
+
+    /* Picks up this host block's rates from the snapshot. While the transport
+       runs, synced slots jump to the phase matching ppqPosition */
+    void startBlock(double ppqPosition, bool transportRunning);
+    /* Renders the next numSamples of every global slot; numSamples is at most maximumBlockSize */
+    void render(int numSamples, int controlInterval);
+    /* Moves every phase on by numSamples without rendering, for blocks where nothing sounds */
+    void skip(int numSamples);
+
+    /* lfo * depth + 1 for the block last rendered, or nullptr when the slot is per-voice or its LFO is off */
+    const float* getModulation(int slot) const
+    {
+        return active[slot] ? modulation.getReadPointer(slot) : nullptr;
+    }
+
+private:
+    const ParameterSnapshot&  parameters;
+    const WavetableBank&      wavetables;
+    juce::AudioBuffer<float>  modulation;
+    double                    sampleRate = 44100.0;
+    juce::uint32              phases[ParameterSnapshot::maxOscillators] = {};
+    juce::uint32              phaseDeltas[ParameterSnapshot::maxOscillators] = {};
+    bool                      active[ParameterSnapshot::maxOscillators] = {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GlobalLfo)
+};
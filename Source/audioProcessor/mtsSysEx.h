@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    mtsSysEx.h
+    Created: 16 Oct 2026
+
+    Parses MIDI Tuning Standard SysEx straight from the raw message bytes,
+    so the audio thread can retune without building a juce::MidiMessage
+    (which allocates for anything longer than a few bytes). Handles bulk
+    and key-based tuning dumps, single note changes with and without a
+    bank, and 1- and 2-byte scale/octave tuning. The device ID, tuning
+    program, bank and channel mask are not checked: the synth has a single
+    tuning, and every message retunes it. Dump checksums are ignored, as
+    plenty of senders get them wrong.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include <cmath>
+
+class MtsSysEx
+{
+public:
+    static constexpr int numKeys = 128;
+
+    /* True if data (from F0, with or without the closing F7) is a MIDI tuning message */
+    static bool isTuningMessage(const juce::uint8* data, int size)
+    {
+        // F0, 7E/7F (non-real time/real time), device ID, 08 (MIDI tuning), sub-ID #2
+        return size >= 6 && data[0] == 0xf0 && (data[1] == 0x7e || data[1] == 0x7f) && data[3] == 0x08;
+    }
+
+    /* Calls retune(key, frequency) for each key an MTS message changes and returns
+       true, or returns false if data isn't a tuning message this understands */
+    template <typename Retune>
+    static bool parse(const juce::uint8* data, int size, Retune&& retune)
+    {
+        if (!isTuningMessage(data, size))
+            return false;
+
+        const auto* body = data + 5;
+        const auto bodySize = size - 5 - (data[size - 1] == 0xf7 ? 1 : 0);
+
+        switch (data[4])
+        {
+            case bulkDump:
+            case keyBasedDump:
+            {
+                // [bank] program, 16-byte name, then a triple per key
+                const auto header = (data[4] == keyBasedDump ? 2 : 1) + nameLength;
+                const auto numFrequencies = juce::jmin(numKeys, (bodySize - header) / 3);
+                for (int key = 0; key < numFrequencies; ++key)
+                    readFrequency(key, body + header + key * 3, retune);
+                return true;
+            }
+
+            case singleNote:
+            case singleNoteWithBank:
+            {
+                // [bank] program, count, then count of (key, triple)
+                const auto header = data[4] == singleNoteWithBank ? 2 : 1;
+                if (bodySize <= header)
+                    return true;
+
+                const auto count = juce::jmin((int) body[header], (bodySize - header - 1) / 4);
+                for (int i = 0; i < count; ++i)
+                {
+                    const auto* change = body + header + 1 + i * 4;
+                    readFrequency(change[0] & 0x7f, change + 1, retune);
+                }
+                return true;
+            }
+
+            case octave1Byte:
+            case octave2Byte:
+            {
+                // 3-byte channel mask, then a cents offset from 12-TET for each pitch class
+                const auto twoByte = data[4] == octave2Byte;
+                const auto bytesPerClass = twoByte ? 2 : 1;
+                if (bodySize < 3 + 12 * bytesPerClass)
+                    return true;
+
+                double cents[12];
+                for (int pitchClass = 0; pitchClass < 12; ++pitchClass)
+                {
+                    const auto* offset = body + 3 + pitchClass * bytesPerClass;
+                    cents[pitchClass] = twoByte ? (((offset[0] << 7) | offset[1]) - 8192) * (100.0 / 8192.0)
+                                                : (double) offset[0] - 64.0;
+                }
+
+                for (int key = 0; key < numKeys; ++key)
+                    retune(key, getFrequency(key + cents[key % 12] / 100.0));
+                return true;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+private:
+    static constexpr int nameLength = 16;
+
+    /* Sub-ID #2 of the MIDI tuning messages */
+    enum SubId
+    {
+        bulkDump           = 0x01,
+        singleNote         = 0x02,
+        keyBasedDump       = 0x04,
+        singleNoteWithBank = 0x07,
+        octave1Byte        = 0x08,
+        octave2Byte        = 0x09
+    };
+
+    /* MTS counts in 12-TET semitones with A4 (69) at 440 Hz */
+    static double getFrequency(double semitones)
+    {
+        return 440.0 * std::pow(2.0, (semitones - 69.0) / 12.0);
+    }
+
+    /* A semitone and a 14-bit fraction of one; 7F 7F 7F leaves the key alone */
+    template <typename Retune>
+    static void readFrequency(int key, const juce::uint8* triple, Retune& retune)
+    {
+        if (triple[0] == 0x7f && triple[1] == 0x7f && triple[2] == 0x7f)
+            return;
+
+        retune(key, getFrequency(triple[0] + ((triple[1] << 7) | triple[2]) / 16384.0));
+    }
+};
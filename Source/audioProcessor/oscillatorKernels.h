@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    oscillatorKernels.h
+    Created: 16 Oct 2026
+
+    Per-block oscillator render loops. Every wave_form is a WavetableBank
+    table, so the inner loop is one table read per sample; kernels are
+    specialised at compile time for the interpolation tier and looked up
+    once per block with getKernel(). The amplitude LFO is its own stage:
+    it fills a block of modulation gains that is multiplied into the
+    envelope before the carrier runs.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "wavetableBank.h"
+
+namespace OscillatorKernels
+{
+    using Interpolation = WavetableBank::Interpolation;
+    static constexpr int numInterpolations = 3;
+
+    /* Everything a kernel touches, copied out of the oscillator for one block */
+    struct State
+    {
+        float*       output = nullptr;
+        const float* envelope = nullptr;
+        int          numSamples = 0;
+        float        gain = 0.0f;
+        float        lfoDepth = 0.0f;
+        juce::uint32 phase = 0;
+        juce::uint32 phaseDelta = 0;
+        juce::uint32 phaseA = 0;
+        juce::uint32 phaseDeltaA = 0;
+        const float* carrierTable = nullptr;
+        const float* lfoTable = nullptr;
+        const float* modulation = nullptr; // shared block of LFO gains, used instead of lfoTable
+    };
+
+    using Kernel = void (*)(State&);
+
+    /* out += carrier * gain * envelope; any LFO has already been folded into the envelope */
+    template <Interpolation interpolation>
+    void render(State& s)
+    {
+        auto phase = s.phase;
+
+        for (int i = 0; i < s.numSamples; ++i)
+        {
+            s.output[i] += WavetableBank::read<interpolation>(s.carrierTable, phase) * s.gain * s.envelope[i];
+            phase += s.phaseDelta;
+        }
+
+        s.phase = phase;
+    }
+
+    /* Writes lfo * lfoDepth + 1 for the block and advances the LFO phase. With a controlInterval
+       above 1 the LFO is read every controlInterval samples and linearly interpolated in between.
+       The LFO sits far below the carrier, so it always reads its table linearly */
+    inline void renderModulation(State& s, float* modulation, int controlInterval)
+    {
+        auto phaseA = s.phaseA;
+
+        if (controlInterval <= 1)
+        {
+            for (int i = 0; i < s.numSamples; ++i)
+            {
+                modulation[i] = WavetableBank::read<Interpolation::linear>(s.lfoTable, phaseA) * s.lfoDepth + 1.0f;
+                phaseA += s.phaseDeltaA;
+            }
+        }
+        else
+        {
+            const auto stepDelta = s.phaseDeltaA * juce::uint32(controlInterval);
+            const auto stepScale = 1.0f / float(controlInterval);
+            auto current = WavetableBank::read<Interpolation::linear>(s.lfoTable, phaseA) * s.lfoDepth + 1.0f;
+
+            for (int i = 0; i < s.numSamples; i += controlInterval)
+            {
+                phaseA += stepDelta;
+                auto next = WavetableBank::read<Interpolation::linear>(s.lfoTable, phaseA) * s.lfoDepth + 1.0f;
+                auto slope = (next - current) * stepScale;
+                auto todo = juce::jmin(controlInterval, s.numSamples - i);
+
+                for (int j = 0; j < todo; ++j)
+                    modulation[i + j] = current + slope * float(j);
+
+                current = next;
+            }
+        }
+
+        s.phaseA += s.phaseDeltaA * juce::uint32(s.numSamples);
+    }
+
+    namespace detail
+    {
+        inline constexpr Kernel table[numInterpolations] = {
+            &render<Interpolation::truncate>,
+            &render<Interpolation::linear>,
+            &render<Interpolation::cubic>
+        };
+    }
+
+    inline Kernel getKernel(Interpolation interpolation)
+    {
+        return detail::table[int(interpolation)];
+    }
+}
@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    parameterSnapshot.h
+    Created: 16 Oct 2026
+
+    Plain copy of every parameter made by Synth::addADSRParameters,
+    addOvertoneParameters and addGainParameters. Synth::updateParameters
+    fills it once per block, so voices see one consistent set of values
+    while the host automates and never touch a parameter atomic themselves.
+    lfoFrequency is derived: detuneA in Hz, or the host tempo when synced.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "envelopeGenerator.h"
+
+struct ParameterSnapshot
+{
+    static constexpr int maxOscillators = 7;
+
+    struct alignas(16) Oscillator
+    {
+        float gain = 0.0f;
+        float detune = 1.0f;
+        int   waveForm = 0;
+        float gainA = 0.0f;
+        float detuneA = 1.0f;
+        int   waveFormA = 0;
+        bool  lfoGlobal = false;
+        int   lfoSync = 0;
+        float lfoFrequency = 1.0f;
+        EnvelopeGenerator::Parameters envelope { 0.0f, 0.0f, 1.0f, 1.0f };
+    };
+
+    alignas(16) Oscillator        oscillators[maxOscillators];
+    EnvelopeGenerator::Parameters adsr;
+    float                         gain = 0.7f;
+};
@@ -0,0 +1,277 @@
+/*
+  ==============================================================================
+
+    partialBank.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "partialBank.h"
+
+#if JUCE_USE_SIMD
+
+PartialBank::PartialBank(int numPartialsToUse, int maximumBlockSizeToUse)
+    : numPartials(numPartialsToUse), maximumBlockSize(maximumBlockSizeToUse)
+{
+    const auto zero = Vec::expand(0.0f);
+
+    Register empty;
+    empty.phase = empty.phaseDelta = empty.phaseA = empty.phaseDeltaA = Phase::expand(0);
+    empty.gain = empty.lfoDepth = zero;
+
+    auto numRegisters = (size_t) (numPartials + lanes - 1) / lanes;
+    registers.assign(numRegisters, empty);
+    // idle lanes keep reading silence, so the gather never has to test for them
+    carrierTables.assign(numRegisters * lanes, WavetableBank::getSilence());
+    lfoTables.assign(numRegisters * lanes, WavetableBank::getSilence());
+    sharedModulation.assign(numRegisters * lanes, nullptr);
+    mix.assign((size_t) maximumBlockSize, zero);
+    modulation.assign((size_t) maximumBlockSize, zero);
+    envelopes.assign(numRegisters * (size_t) maximumBlockSize, zero);
+}
+
+void PartialBank::setPartial(int index, const Partial& partial, int numSamples)
+{
+    jassert(juce::isPositiveAndBelow(index, numPartials));
+    jassert(numSamples > 0 && numSamples <= (int) mix.size());
+    jassert(partial.carrierTable != nullptr && partial.envelope != nullptr);
+
+    auto& reg = registers[(size_t) (index / lanes)];
+    auto lane = (size_t) (index % lanes);
+    const auto hasShared = partial.modulation != nullptr;
+    const auto hasLfo = partial.lfoTable != nullptr && !hasShared;
+
+    reg.phase.set(lane, partial.phase);
+    reg.phaseDelta.set(lane, partial.phaseDelta);
+    reg.phaseA.set(lane, partial.phaseA);
+    reg.phaseDeltaA.set(lane, partial.phaseDeltaA);
+    reg.gain.set(lane, partial.gain);
+    reg.lfoDepth.set(lane, hasLfo ? partial.lfoDepth : 0.0f);
+
+    // every sample's level, so curved and zero-length segments sound as they do on the scalar path
+    auto* envelope = envelopes.data() + (size_t) (index / lanes) * (size_t) maximumBlockSize;
+    for (int i = 0; i < numSamples; ++i)
+        envelope[i].set(lane, partial.envelope[i]);
+
+    reg.carrierLanes |= 1u << lane;
+    if (hasLfo)
+        reg.lfoLanes |= 1u << lane;
+    else
+        reg.lfoLanes &= ~(1u << lane);
+    if (hasShared)
+        reg.sharedLanes |= 1u << lane;
+    else
+        reg.sharedLanes &= ~(1u << lane);
+
+    carrierTables[(size_t) index] = partial.carrierTable;
+    lfoTables[(size_t) index] = hasLfo ? partial.lfoTable : WavetableBank::getSilence();
+    sharedModulation[(size_t) index] = partial.modulation;
+}
+
+void PartialBank::clearPartial(int index)
+{
+    jassert(juce::isPositiveAndBelow(index, numPartials));
+
+    auto& reg = registers[(size_t) (index / lanes)];
+    auto lane = (size_t) (index % lanes);
+
+    reg.gain.set(lane, 0.0f);
+    reg.lfoDepth.set(lane, 0.0f);
+    reg.carrierLanes &= ~(1u << lane);
+    reg.lfoLanes &= ~(1u << lane);
+    reg.sharedLanes &= ~(1u << lane);
+    carrierTables[(size_t) index] = WavetableBank::getSilence();
+    lfoTables[(size_t) index] = WavetableBank::getSilence();
+    sharedModulation[(size_t) index] = nullptr;
+}
+
+juce::uint32 PartialBank::getPhase(int index) const
+{
+    return registers[(size_t) (index / lanes)].phase.get((size_t) (index % lanes));
+}
+
+juce::uint32 PartialBank::getPhaseA(int index) const
+{
+    return registers[(size_t) (index / lanes)].phaseA.get((size_t) (index % lanes));
+}
+
+template <PartialBank::Interpolation interpolation>
+PartialBank::Vec PartialBank::read(Phase phase, const float* const* tables)
+{
+    alignas(sizeof(Vec)) float xm1[lanes], x0[lanes], x1[lanes], x2[lanes], frac[lanes];
+
+    for (size_t lane = 0; lane < (size_t) lanes; ++lane)
+    {
+        auto bits = phase.get(lane);
+        auto* sample = tables[lane] + (bits >> (32 - WavetableBank::tableBits));
+        x0[lane] = sample[0];
+
+        if constexpr (interpolation != Interpolation::truncate)
+        {
+            x1[lane] = sample[1];
+            frac[lane] = PhaseAccumulator::toUnit(bits << WavetableBank::tableBits);
+        }
+
+        if constexpr (interpolation == Interpolation::cubic)
+        {
+            xm1[lane] = sample[-1];
+            x2[lane] = sample[2];
+        }
+    }
+
+    if constexpr (interpolation == Interpolation::truncate)
+    {
+        return Vec::fromRawArray(x0);
+    }
+    else if constexpr (interpolation == Interpolation::linear)
+    {
+        auto a = Vec::fromRawArray(x0);
+        return Vec::multiplyAdd(a, Vec::fromRawArray(x1) - a, Vec::fromRawArray(frac));
+    }
+    else
+    {
+        // 4-point, 3rd-order Hermite, as WavetableBank::read
+        auto p0 = Vec::fromRawArray(xm1), p1 = Vec::fromRawArray(x0), p2 = Vec::fromRawArray(x1), p3 = Vec::fromRawArray(x2);
+        auto t = Vec::fromRawArray(frac);
+        auto c1 = (p2 - p0) * 0.5f;
+        auto c2 = p0 - p1 * 2.5f + p2 * 2.0f - p3 * 0.5f;
+        auto c3 = (p3 - p0) * 0.5f + (p1 - p2) * 1.5f;
+        return Vec::multiplyAdd(p1, Vec::multiplyAdd(c1, Vec::multiplyAdd(c2, c3, t), t), t);
+    }
+}
+
+void PartialBank::renderModulation(Register& reg, const float* const* tables, int numSamples, int controlInterval)
+{
+    const auto one = Vec::expand(1.0f);
+    auto phaseA = reg.phaseA;
+
+    if (controlInterval <= 1)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            modulation[(size_t) i] = Vec::multiplyAdd(one, read<Interpolation::linear>(phaseA, tables), reg.lfoDepth);
+            phaseA = phaseA + reg.phaseDeltaA;
+        }
+    }
+    else
+    {
+        auto stepDelta = reg.phaseDeltaA;
+        for (size_t lane = 0; lane < (size_t) lanes; ++lane)
+            stepDelta.set(lane, reg.phaseDeltaA.get(lane) * juce::uint32(controlInterval));
+
+        const auto stepScale = 1.0f / float(controlInterval);
+        auto current = Vec::multiplyAdd(one, read<Interpolation::linear>(phaseA, tables), reg.lfoDepth);
+
+        for (int i = 0; i < numSamples; i += controlInterval)
+        {
+            phaseA = phaseA + stepDelta;
+            auto next = Vec::multiplyAdd(one, read<Interpolation::linear>(phaseA, tables), reg.lfoDepth);
+            auto slope = (next - current) * stepScale;
+            auto todo = juce::jmin(controlInterval, numSamples - i);
+
+            auto value = current;
+            for (int j = 0; j < todo; ++j)
+            {
+                modulation[(size_t) (i + j)] = value;
+                value = value + slope;
+            }
+
+            current = next;
+        }
+    }
+}
+
+void PartialBank::applySharedModulation(const Register& reg, const float* const* sources, int numSamples)
+{
+    // one partial of neighbouring voices: every sounding lane follows the same GlobalLfo slot
+    const float* common = nullptr;
+    auto allCommon = reg.lfoLanes == 0 && (reg.carrierLanes & ~reg.sharedLanes) == 0;
+
+    for (size_t lane = 0; lane < (size_t) lanes && allCommon; ++lane)
+    {
+        if ((reg.sharedLanes & (1u << lane)) == 0)
+            continue;
+
+        allCommon = common == nullptr || common == sources[lane];
+        common = sources[lane];
+    }
+
+    if (allCommon)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            modulation[(size_t) i] = Vec::expand(common[i]);
+        return;
+    }
+
+    // lanes fed from a shared buffer have no LFO of their own, so their gains replace the 1s
+    if (reg.lfoLanes == 0)
+        std::fill(modulation.begin(), modulation.begin() + numSamples, Vec::expand(1.0f));
+
+    for (size_t lane = 0; lane < (size_t) lanes; ++lane)
+    {
+        if ((reg.sharedLanes & (1u << lane)) == 0)
+            continue;
+
+        for (int i = 0; i < numSamples; ++i)
+            modulation[(size_t) i].set(lane, sources[lane][i]);
+    }
+}
+
+template <PartialBank::Interpolation interpolation>
+void PartialBank::renderRegisters(int numSamples, int lfoControlInterval)
+{
+    for (size_t r = 0; r < registers.size(); ++r)
+    {
+        auto& reg = registers[r];
+        if (reg.carrierLanes == 0)
+            continue;
+
+        const auto* carrierTablesForRegister = carrierTables.data() + r * (size_t) lanes;
+        const auto hasLfo = (reg.lfoLanes | reg.sharedLanes) != 0;
+
+        if (reg.lfoLanes != 0)
+            renderModulation(reg, lfoTables.data() + r * (size_t) lanes, numSamples, lfoControlInterval);
+        if (reg.sharedLanes != 0)
+            applySharedModulation(reg, sharedModulation.data() + r * (size_t) lanes, numSamples);
+
+        auto phase = reg.phase;
+        const auto* envelope = envelopes.data() + r * (size_t) maximumBlockSize;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto sample = read<interpolation>(phase, carrierTablesForRegister) * reg.gain * envelope[i];
+
+            if (hasLfo)
+                sample = sample * modulation[(size_t) i];
+
+            mix[(size_t) i] = mix[(size_t) i] + sample;
+            phase = phase + reg.phaseDelta;
+        }
+
+        reg.phase = phase;
+
+        // every lane's LFO keeps running, whether or not it is applied
+        for (size_t lane = 0; lane < (size_t) lanes; ++lane)
+            reg.phaseA.set(lane, reg.phaseA.get(lane) + reg.phaseDeltaA.get(lane) * juce::uint32(numSamples));
+    }
+}
+
+void PartialBank::render(float* output, int numSamples, Interpolation interpolation, int lfoControlInterval)
+{
+    jassert(numSamples <= (int) mix.size());
+
+    std::fill(mix.begin(), mix.begin() + numSamples, Vec::expand(0.0f));
+
+    switch (interpolation)
+    {
+        case Interpolation::truncate: renderRegisters<Interpolation::truncate>(numSamples, lfoControlInterval); break;
+        case Interpolation::linear:   renderRegisters<Interpolation::linear>(numSamples, lfoControlInterval);   break;
+        case Interpolation::cubic:    renderRegisters<Interpolation::cubic>(numSamples, lfoControlInterval);    break;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+        output[i] += mix[(size_t) i].sum();
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    partialBank.h
+    Created: 16 Oct 2026
+
+    Structure-of-arrays state for a set of partials. Each partial occupies
+    one juce::dsp::SIMDRegister lane, so phases, gains, LFOs and envelopes
+    advance together and the sum is written once per sample. A Voice owns
+    one for its own partials; Synth owns one for every voice at once, laid
+    out partial-major so a register holds one partial of neighbouring
+    voices. Table reads are gathered per lane and interpolated in SIMD.
+    Only compiled when JUCE_USE_SIMD is available; the scalar
+    OscillatorKernels path is used otherwise.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "oscillatorKernels.h"
+#include <vector>
+
+#if JUCE_USE_SIMD
+
+class PartialBank
+{
+public:
+    using Vec  = juce::dsp::SIMDRegister<float>;
+    using Phase = juce::dsp::SIMDRegister<juce::uint32>;
+    using Interpolation = WavetableBank::Interpolation;
+    static constexpr int lanes = (int) Vec::SIMDNumElements;
+
+    /* Block-rate description of one partial. Phases are PhaseAccumulator values;
+       a null lfoTable turns the LFO off. modulation, if set, is a block of
+       LFO gains shared with other partials (see GlobalLfo) used instead.
+       envelope is the block's per-sample levels, copied in by setPartial */
+    struct Partial
+    {
+        const float* carrierTable = nullptr;
+        const float* lfoTable = nullptr;
+        const float* modulation = nullptr;
+        juce::uint32 phase = 0;
+        juce::uint32 phaseDelta = 0;
+        juce::uint32 phaseA = 0;
+        juce::uint32 phaseDeltaA = 0;
+        float gain = 0.0f;
+        float lfoDepth = 0.0f;
+        const float* envelope = nullptr;
+    };
+
+    PartialBank(int numPartials, int maximumBlockSize);
+
+    /* Loads a partial into its lane for the next render() of numSamples */
+    void setPartial(int index, const Partial& partial, int numSamples);
+    /* Silences a lane; its phases are left untouched */
+    void clearPartial(int index);
+
+    /* Adds the sum of all partials to output. LFOs are read every lfoControlInterval
+       samples, see OscillatorKernels::renderModulation */
+    void render(float* output, int numSamples, Interpolation interpolation, int lfoControlInterval = 1);
+
+    juce::uint32 getPhase(int index) const;
+    juce::uint32 getPhaseA(int index) const;
+
+private:
+    struct Register
+    {
+        Phase phase, phaseDelta, phaseA, phaseDeltaA;
+        Vec gain, lfoDepth;
+        juce::uint32 carrierLanes = 0, lfoLanes = 0, sharedLanes = 0;
+    };
+
+    template <Interpolation interpolation>
+    static Vec read(Phase phase, const float* const* tables);
+
+    void renderModulation(Register& reg, const float* const* tables, int numSamples, int controlInterval);
+    void applySharedModulation(const Register& reg, const float* const* sources, int numSamples);
+
+    template <Interpolation interpolation>
+    void renderRegisters(int numSamples, int lfoControlInterval);
+
+    int numPartials;
+    int maximumBlockSize;
+    std::vector<Register> registers;
+    std::vector<const float*> carrierTables, lfoTables, sharedModulation;
+    std::vector<Vec> mix, modulation;
+    std::vector<Vec> envelopes;  // maximumBlockSize levels per register
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PartialBank)
+};
+
+#endif
@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+    phaseAccumulator.h
+    Created: 16 Oct 2026
+
+    Fixed-point oscillator phase. A full cycle is 2^32, so advancing is one
+    unsigned add that wraps by itself, the top bits index a table and the
+    bottom bits are the interpolation fraction. Increments are quantised to
+    2^-32 of a cycle and never accumulate rounding error, which keeps long
+    drones on pitch.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include <cmath>
+
+namespace PhaseAccumulator
+{
+    static constexpr double cycle = 4294967296.0;
+    static constexpr float  unitScale = 1.0f / 16777216.0f;
+
+    /* Phase increment for a number of cycles per sample; whole cycles fold away like an angle would */
+    inline juce::uint32 getIncrement(double cyclesPerSample)
+    {
+        cyclesPerSample -= std::floor(cyclesPerSample);
+        return juce::uint32(juce::uint64(cyclesPerSample * cycle + 0.5) & 0xffffffff);
+    }
+
+    /* Phase increment per sample for a frequency */
+    inline juce::uint32 getIncrement(double frequency, double sampleRate)
+    {
+        return sampleRate > 0.0 ? getIncrement(frequency / sampleRate) : 0;
+    }
+
+    /* Phase as a float in [0, 1), using its top 24 bits so the conversion is exact */
+    inline float toUnit(juce::uint32 phase)
+    {
+        return float(phase >> 8) * unitScale;
+    }
+}
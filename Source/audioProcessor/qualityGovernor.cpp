@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    qualityGovernor.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "qualityGovernor.h"
+#include <cmath>
+
+namespace
+{
+    using Interpolation = WavetableBank::Interpolation;
+
+    // tier 0 is full quality; each step gives up a little more
+    const QualityGovernor::Tier tiers[QualityGovernor::numTiers] = {
+        { 1.0e-4f, Interpolation::cubic,    1.0f  },
+        { 1.0e-3f, Interpolation::cubic,    1.0f  },
+        { 1.0e-3f, Interpolation::linear,   1.0f  },
+        { 3.0e-3f, Interpolation::linear,   0.5f  },
+        { 1.0e-2f, Interpolation::truncate, 0.25f }
+    };
+
+    constexpr double smoothingSeconds = 0.1;
+}
+
+const QualityGovernor::Tier& QualityGovernor::getTier(int index)
+{
+    return tiers[juce::jlimit(0, numTiers - 1, index)];
+}
+
+void QualityGovernor::setSampleRate(double newSampleRate)
+{
+    jassert(newSampleRate > 0.0);
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void QualityGovernor::reset()
+{
+    load = 0.0;
+    secondsOver = 0.0;
+    secondsUnder = 0.0;
+    tier = 0;
+}
+
+bool QualityGovernor::registerBlock(double milliseconds, int numSamples)
+{
+    if (numSamples <= 0)
+        return false;
+
+    const auto seconds = numSamples / sampleRate;
+    const auto blockLoad = milliseconds / (1000.0 * seconds);
+
+    // an overrun lifts the estimate at once instead of being averaged away
+    const auto coefficient = 1.0 - std::exp(-seconds / smoothingSeconds);
+    load = blockLoad > 1.0 ? juce::jmax(load, blockLoad) : load + (blockLoad - load) * coefficient;
+
+    secondsOver = load > degradeLoad ? secondsOver + seconds : 0.0;
+    secondsUnder = load < restoreLoad ? secondsUnder + seconds : 0.0;
+
+    if (secondsOver >= degradeSeconds && tier < numTiers - 1)
+    {
+        ++tier;
+        secondsOver = 0.0;
+        return true;
+    }
+
+    if (secondsUnder >= restoreSeconds && tier > 0)
+    {
+        --tier;
+        secondsUnder = 0.0;
+        return true;
+    }
+
+    return false;
+}
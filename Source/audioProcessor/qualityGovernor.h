@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    qualityGovernor.h
+    Created: 16 Oct 2026
+
+    Watches how long each processBlock takes against its real-time budget
+    (numSamples / sampleRate) and steps Synth through quality tiers: a
+    higher floor below which partials are culled, a cheaper wavetable
+    interpolation, and fewer voices. It degrades one tier as soon as the
+    load stays high for a moment and only restores one after a long quiet
+    spell, so a borderline session settles instead of flapping.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "wavetableBank.h"
+
+class QualityGovernor
+{
+public:
+    struct Tier
+    {
+        float                        partialFloor;   // partials whose peak stays below this are skipped
+        WavetableBank::Interpolation interpolation;  // best read allowed; the user's choice can be lower
+        float                        voiceShare;     // fraction of the polyphony allowed to sound
+    };
+
+    static constexpr int    numTiers = 5;
+    static constexpr double degradeLoad = 0.8;
+    static constexpr double restoreLoad = 0.5;
+    static constexpr double degradeSeconds = 0.15;
+    static constexpr double restoreSeconds = 2.0;
+
+    QualityGovernor() = default;
+
+    void setSampleRate(double newSampleRate);
+    void reset();
+
+    /* Folds one block's render time into the load estimate; true when the tier changed */
+    bool registerBlock(double milliseconds, int numSamples);
+
+    int         getTierIndex() const { return tier; }
+    const Tier& getTier() const { return getTier(tier); }
+    static const Tier& getTier(int index);
+
+    /* Smoothed fraction of the real-time budget being used */
+    double getLoad() const { return load; }
+
+private:
+    double sampleRate = 44100.0;
+    double load = 0.0;
+    double secondsOver = 0.0;
+    double secondsUnder = 0.0;
+    int    tier = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(QualityGovernor)
+};
@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    scalaTuning.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "scalaTuning.h"
+#include <cmath>
+#include <vector>
+
+juce::StringArray ScalaTuning::getDataLines(const juce::String& text)
+{
+    juce::StringArray lines;
+    lines.addLines(text);
+
+    juce::StringArray data;
+    for (auto& line : lines)
+        if (!line.startsWithChar('!'))
+            data.add(line.trim());
+
+    return data;
+}
+
+bool ScalaTuning::parsePitch(const juce::String& line, double& ratio)
+{
+    const auto value = line.upToFirstOccurrenceOf(" ", false, false).upToFirstOccurrenceOf("\t", false, false);
+    if (value.isEmpty())
+        return false;
+
+    if (value.containsChar('.'))
+    {
+        if (!value.containsOnly("+-0123456789."))
+            return false;
+
+        ratio = std::pow(2.0, value.getDoubleValue() / 1200.0);
+        return true;
+    }
+
+    if (!value.containsOnly("0123456789/"))
+        return false;
+
+    const auto numerator = value.upToFirstOccurrenceOf("/", false, false).getLargeIntValue();
+    const auto denominator = value.containsChar('/') ? value.fromFirstOccurrenceOf("/", false, false).getLargeIntValue() : 1;
+    if (numerator <= 0 || denominator <= 0)
+        return false;
+
+    ratio = (double) numerator / (double) denominator;
+    return true;
+}
+
+bool ScalaTuning::parseScale(const juce::String& text, TuningMap& map, juce::String& description, juce::String& error)
+{
+    auto lines = getDataLines(text);
+    if (lines.size() < 2)
+    {
+        error = "Missing description or note count";
+        return false;
+    }
+
+    // the description may be blank, but the lines after it may not
+    const auto newDescription = lines[0];
+    lines.remove(0);
+    lines.removeEmptyStrings();
+
+    const auto countText = lines[0].upToFirstOccurrenceOf(" ", false, false);
+    const auto count = countText.getIntValue();
+    if (countText.isEmpty() || !countText.containsOnly("0123456789") || lines.size() - 1 < count)
+    {
+        error = "Note count doesn't match the pitches given";
+        return false;
+    }
+
+    std::vector<double> ratios;
+    ratios.reserve((size_t) count);
+    for (int i = 1; i <= count; ++i)
+    {
+        double ratio = 1.0;
+        if (!parsePitch(lines[i], ratio))
+        {
+            error = "Can't read pitch \"" + lines[i] + "\"";
+            return false;
+        }
+        ratios.push_back(ratio);
+    }
+
+    // the last pitch is the period; at or below 1/1, or missing, it would fold every key onto the same few pitches
+    if (ratios.empty() || !(ratios.back() > 1.0))
+    {
+        error = "The last pitch is the period and must be above 1/1";
+        return false;
+    }
+
+    const auto period = ratios.back();
+    ratios.pop_back();
+    map.setScale(ratios, period);
+    description = newDescription;
+    return true;
+}
+
+bool ScalaTuning::parsePitchList(const juce::String& text, std::vector<double>& degreeRatios,
+                                 double& periodRatio, juce::String& error)
+{
+    juce::StringArray pitches;
+    pitches.addTokens(text, " \t\r\n,", "");
+    pitches.removeEmptyStrings();
+    if (pitches.isEmpty())
+    {
+        error = "No pitches given";
+        return false;
+    }
+
+    std::vector<double> ratios;
+    ratios.reserve((size_t) pitches.size());
+    for (auto& pitch : pitches)
+    {
+        double ratio = 1.0;
+        if (!parsePitch(pitch, ratio))
+        {
+            error = "Can't read pitch \"" + pitch + "\"";
+            return false;
+        }
+        ratios.push_back(ratio);
+    }
+
+    // a period at or below 1/1 would fold every key onto the same few pitches
+    const auto period = ratios.back();
+    if (!(period > 1.0))
+    {
+        error = "The last pitch is the period and must be above 1/1";
+        return false;
+    }
+
+    ratios.pop_back();
+    degreeRatios = std::move(ratios);
+    periodRatio = period;
+    return true;
+}
+
+bool ScalaTuning::parseKeyboardMapping(const juce::String& text, TuningMap& map, juce::String& error)
+{
+    auto lines = getDataLines(text);
+    lines.removeEmptyStrings();
+    if (lines.size() < 7)
+    {
+        error = "Keyboard mapping needs seven header lines";
+        return false;
+    }
+
+    auto getInt = [&lines](int i) { return lines[i].upToFirstOccurrenceOf(" ", false, false).getIntValue(); };
+
+    const auto mapSize = getInt(0);
+    const auto firstKey = getInt(1);
+    const auto lastKey = getInt(2);
+    const auto middleKey = getInt(3);
+    const auto referenceKey = getInt(4);
+    const auto referenceFrequency = lines[5].upToFirstOccurrenceOf(" ", false, false).getDoubleValue();
+    const auto octaveDegree = getInt(6);
+
+    if (mapSize < 0 || referenceFrequency <= 0.0)
+    {
+        error = "Bad map size or reference frequency";
+        return false;
+    }
+
+    // slots past the end of the file are unmapped
+    std::vector<int> slots((size_t) mapSize, (int) TuningMap::unmappedSlot);
+    for (int i = 0; i < mapSize && 7 + i < lines.size(); ++i)
+    {
+        const auto entry = lines[7 + i].upToFirstOccurrenceOf(" ", false, false);
+        if (entry.equalsIgnoreCase("x"))
+            continue;
+
+        if (!entry.containsOnly("0123456789"))
+        {
+            error = "Can't read mapping entry \"" + entry + "\"";
+            return false;
+        }
+        slots[(size_t) i] = entry.getIntValue();
+    }
+
+    // a formal octave of 0 means the scale's own period
+    map.setKeyboard(slots, octaveDegree > 0 ? octaveDegree : map.getScaleSize(), middleKey, referenceKey, referenceFrequency);
+    map.setKeyRange(firstKey, lastKey);
+    return true;
+}
+
+void ScalaTuning::setDefaultKeyboardMapping(TuningMap& map)
+{
+    map.setLinearKeyboard(60, 60, 261.6255653);
+    map.setKeyRange(0, TuningMap::numKeys - 1);
+}
+
+bool ScalaTuning::loadFile(const juce::File& scaleFile, TuningMap& map, juce::String& description, juce::String& error)
+{
+    TuningMap loaded;
+    if (!parseScale(scaleFile.loadFileAsString(), loaded, description, error))
+        return false;
+
+    const auto mappingFile = scaleFile.withFileExtension("kbm");
+    if (mappingFile.existsAsFile())
+    {
+        if (!parseKeyboardMapping(mappingFile.loadFileAsString(), loaded, error))
+            return false;
+    }
+    else
+    {
+        setDefaultKeyboardMapping(loaded);
+    }
+
+    map = loaded;
+    return true;
+}
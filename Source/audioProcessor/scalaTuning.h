@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    scalaTuning.h
+    Created: 16 Oct 2026
+
+    Reads Scala scale (.scl) and keyboard mapping (.kbm) files into a
+    TuningMap. Pitches may be cents (anything with a '.') or ratios
+    ("3/2" or "2"); lines starting with '!' are comments and anything
+    after a pitch on its line is ignored. A scale loaded without a .kbm
+    gets Scala's default mapping: one degree per key from middle C, tuned
+    to 261.6255653 Hz.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "tuningMap.h"
+
+class ScalaTuning
+{
+public:
+    /* Sets map's scale from .scl text; its last pitch, the period, must be above 1/1.
+       On failure returns false, leaves map alone and fills error */
+    static bool parseScale(const juce::String& text, TuningMap& map, juce::String& description, juce::String& error);
+
+    /* Sets map's keyboard from .kbm text. On failure returns false, leaves map alone and fills error */
+    static bool parseKeyboardMapping(const juce::String& text, TuningMap& map, juce::String& error);
+
+    /* Reads a list of pitches written as in a .scl, separated by spaces or commas, the last
+       being the period: "9/8 5/4 4/3 3/2 5/3 15/8 2" or "146.3 292.6 1902". On failure
+       returns false, leaves degreeRatios and periodRatio alone and fills error */
+    static bool parsePitchList(const juce::String& text, std::vector<double>& degreeRatios,
+                               double& periodRatio, juce::String& error);
+
+    /* Scala's mapping when no .kbm is given */
+    static void setDefaultKeyboardMapping(TuningMap& map);
+
+    /* Parses a .scl file, with the .kbm of the same name next to it if there is one */
+    static bool loadFile(const juce::File& scaleFile, TuningMap& map, juce::String& description, juce::String& error);
+
+private:
+    /* The lines that aren't comments, trimmed */
+    static juce::StringArray getDataLines(const juce::String& text);
+    static bool parsePitch(const juce::String& line, double& ratio);
+};
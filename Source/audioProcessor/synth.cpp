@@ -9,7 +9,7 @@
 */
 
 #include "synth.h"
-#include "../components/microtonal/Microtonal.h"
+#include "mtsSysEx.h"
 
 namespace IDs
 {
@@ -18,156 +18,1301 @@ namespace IDs
     static juce::String paramSustain{ "sustain" };
     static juce::String paramRelease{ "release" };
     static juce::String paramGain{ "gain" };
+    static juce::String paramVoiceBank{ "voiceBank" };
+    static juce::String paramInterpolation{ "interpolation" };
+    static juce::String paramEnvelopeCurve{ "envelopeCurve" };
+    static juce::String paramLfoControlInterval{ "lfoControlInterval" };
+    static juce::String paramRenderThreads{ "renderThreads" };
+    static juce::String paramPolyphony{ "polyphony" };
+    static juce::String paramStealPolicy{ "stealPolicy" };
+    static juce::String paramSilenceThreshold{ "silenceThreshold" };
+    static juce::String paramAdaptiveQuality{ "adaptiveQuality" };
+    static juce::String paramTuningGlide{ "tuningGlide" };
+    static juce::String paramAdaptiveTuning{ "adaptiveTuning" };
+    static juce::String paramAdaptiveDrift{ "adaptiveDrift" };
+    static juce::String paramAdaptiveTolerance{ "adaptiveTolerance" };
+    static juce::String paramAdaptiveAnchor{ "adaptiveAnchor" };
+}
+
+namespace
+{
+    bool isSameMapping(const MicrotonalConfig& a, const MicrotonalConfig& b)
+    {
+        if (a.spanKeyboard != b.spanKeyboard || a.divisions != b.divisions || a.base_frequency != b.base_frequency
+            || a.period != b.period || a.scale != b.scale)
+            return false;
+
+        for (int i = 0; i < TuningTable::mappedKeys; ++i)
+            if (a.frequencies[i].frequency != b.frequencies[i].frequency)
+                return false;
+
+        return true;
+    }
 }
 
 //==============================================================================
 
-int Synth::numOscillators = 7;
-extern MicrotonalConfig microtonalMappings[7];
-extern int mappingGroup;
-vector<juce::String> instrumentNames;
+int Synth::numOscillators = 7;
+
+
+void Synth::addADSRParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    auto attack = std::make_unique<juce::AudioParameterFloat>(IDs::paramAttack, "Attack", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.10f);
+    auto decay = std::make_unique<juce::AudioParameterFloat>(IDs::paramDecay, "Decay", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.10f);
+    auto sustain = std::make_unique<juce::AudioParameterFloat>(IDs::paramSustain, "Sustain", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f);
+    auto release = std::make_unique<juce::AudioParameterFloat>(IDs::paramRelease, "Release", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.10f);
+
+    auto group = std::make_unique<juce::AudioProcessorParameterGroup>("adsr", "ADRS", "|",
+        std::move(attack),
+        std::move(decay),
+        std::move(sustain),
+        std::move(release));
+    layout.add(std::move(group));
+}
+
+void Synth::addOvertoneParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    auto group = std::make_unique<juce::AudioProcessorParameterGroup>("oscillators", "Oscillators", "|");
+    for (int i = 0; i < Synth::numOscillators; ++i)
+    {
+        group->addChild(std::make_unique<juce::AudioParameterFloat>("osc" + juce::String(i), "Oscillator " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
+        group->addChild(std::make_unique<juce::AudioParameterFloat>("detune" + juce::String(i), "Detune " + juce::String(i), juce::NormalisableRange<float>(0.0625f, 16.0f, 0.0001f), 1.0f));
+		group->addChild(std::make_unique<juce::AudioParameterChoice>("wave_form" + juce::String(i), "wave_form " + juce::String(i),
+            juce::StringArray({ "Sin","Squ","Saw","Tri","Cu1","Cu2","Cu3","Cu4","Cu5","Cu6","Cu7" }),
+            0));
+        group->addChild(std::make_unique<juce::AudioParameterFloat>("oscA" + juce::String(i), "OscillatorA " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
+        group->addChild(std::make_unique<juce::AudioParameterFloat>("detuneA" + juce::String(i), "DetuneA " + juce::String(i), juce::NormalisableRange<float>(0.0625f, 16.0f, 0.0001f), 1.0f));
+        group->addChild(std::make_unique<juce::AudioParameterChoice>("wave_formA" + juce::String(i), "wave_formA " + juce::String(i),
+            juce::StringArray({ "Sin","Squ","Saw","Tri","Cu1","Cu2","Cu3","Cu4","Cu5","Cu6","Cu7" }),
+            0));
+        group->addChild(std::make_unique<juce::AudioParameterFloat>("attackA" + juce::String(i), "AttackA " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.00f));
+        group->addChild(std::make_unique<juce::AudioParameterFloat>("decayA" + juce::String(i), "DecayA " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.00f));
+        group->addChild(std::make_unique<juce::AudioParameterFloat>("sustainA" + juce::String(i), "SustainA " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f));
+        group->addChild(std::make_unique<juce::AudioParameterFloat>("releaseA" + juce::String(i), "ReleaseA " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f));
+
+	}
+
+    //instrumentNames.push_back("preset1");
+    //instrumentNames.push_back("preset2");
+    //instrumentNames.push_back("preset3");
+
+    //auto groupInstruments = std::make_unique<juce::AudioProcessorParameterGroup>("instruments", "Instruments", "|");
+    //groupInstruments->addChild(std::make_unique<juce::AudioParameterChoice>("instrumentPreset", "Instrument_Preset", juce::StringArray({ "preset342", "preset54"}), 0));
+
+
+    
+    
+    //layout.add(std::move(groupInstruments));
+    layout.add(std::move(group));
+
+}
+
+
+void Synth::addOscillatorLfoParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    auto group = std::make_unique<juce::AudioProcessorParameterGroup>("oscillatorLfos", "Oscillator LFOs", "|");
+    for (int i = 0; i < Synth::numOscillators; ++i)
+    {
+        group->addChild(std::make_unique<juce::AudioParameterChoice>("lfoModeA" + juce::String(i), "LfoModeA " + juce::String(i),
+            juce::StringArray({ "Voice","Global" }),
+            0));
+        group->addChild(std::make_unique<juce::AudioParameterChoice>("lfoSyncA" + juce::String(i), "LfoSyncA " + juce::String(i),
+            GlobalLfo::getSyncNames(),
+            0));
+    }
+
+    layout.add(std::move(group));
+}
+
+void Synth::addGainParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    auto gain = std::make_unique<juce::AudioParameterFloat>(IDs::paramGain, "Gain", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.70f);
+
+    layout.add(std::make_unique<juce::AudioProcessorParameterGroup>("output", "Output", "|", std::move(gain)));
+}
+
+void Synth::addEngineParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    auto voiceBank = std::make_unique<juce::AudioParameterBool>(IDs::paramVoiceBank, "Voice Bank", false);
+    // in WavetableBank::Interpolation order
+    auto interpolation = std::make_unique<juce::AudioParameterChoice>(IDs::paramInterpolation, "Interpolation",
+        juce::StringArray{ "Truncate", "Linear", "Cubic" }, 2);
+    // in EnvelopeGenerator::Curve order
+    auto envelopeCurve = std::make_unique<juce::AudioParameterChoice>(IDs::paramEnvelopeCurve, "Envelope Curve",
+        juce::StringArray{ "Linear", "Exponential" }, 0);
+    auto lfoControlInterval = std::make_unique<juce::AudioParameterInt>(IDs::paramLfoControlInterval, "LFO Control Interval",
+        1, internalBlockSize, 1);
+    auto renderThreads = std::make_unique<juce::AudioParameterInt>(IDs::paramRenderThreads, "Render Threads", 0, 8, 0);
+    auto polyphony = std::make_unique<juce::AudioParameterInt>(IDs::paramPolyphony, "Polyphony",
+        1, VoiceAllocator::maxVoices, defaultPolyphony);
+    // in VoiceAllocator::StealPolicy order
+    auto stealPolicy = std::make_unique<juce::AudioParameterChoice>(IDs::paramStealPolicy, "Voice Stealing",
+        juce::StringArray{ "Oldest", "Quietest", "Same note" }, 0);
+    auto silenceThreshold = std::make_unique<juce::AudioParameterFloat>(IDs::paramSilenceThreshold, "Silence Threshold",
+        juce::NormalisableRange<float>(-120.0f, -40.0f, 1.0f), defaultSilenceThresholdDb);
+    auto adaptiveQuality = std::make_unique<juce::AudioParameterBool>(IDs::paramAdaptiveQuality, "Adaptive Quality", true);
+
+    layout.add(std::make_unique<juce::AudioProcessorParameterGroup>("engine", "Engine", "|",
+        std::move(voiceBank),
+        std::move(interpolation),
+        std::move(envelopeCurve),
+        std::move(lfoControlInterval),
+        std::move(renderThreads),
+        std::move(polyphony),
+        std::move(stealPolicy),
+        std::move(silenceThreshold),
+        std::move(adaptiveQuality)));
+}
+
+void Synth::addTuningParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+{
+    auto tuningGlide = std::make_unique<juce::AudioParameterFloat>(IDs::paramTuningGlide, "Tuning Glide",
+        juce::NormalisableRange<float>(0.0f, 2.0f, 0.01f), 0.0f);
+    auto adaptiveTuning = std::make_unique<juce::AudioParameterBool>(IDs::paramAdaptiveTuning, "Adaptive Tuning", false);
+    auto adaptiveDrift = std::make_unique<juce::AudioParameterFloat>(IDs::paramAdaptiveDrift, "Adaptive Drift",
+        juce::NormalisableRange<float>(0.0f, 50.0f, 0.1f), 20.0f);
+    auto adaptiveTolerance = std::make_unique<juce::AudioParameterFloat>(IDs::paramAdaptiveTolerance, "Adaptive Tolerance",
+        juce::NormalisableRange<float>(0.0f, 50.0f, 0.1f), 30.0f);
+    // in AdaptiveTuning::Anchor order
+    auto adaptiveAnchor = std::make_unique<juce::AudioParameterChoice>(IDs::paramAdaptiveAnchor, "Adaptive Anchor",
+        juce::StringArray{ "Root", "Mean" }, 1);
+
+    layout.add(std::make_unique<juce::AudioProcessorParameterGroup>("tuning", "Tuning", "|",
+        std::move(tuningGlide),
+        std::move(adaptiveTuning),
+        std::move(adaptiveDrift),
+        std::move(adaptiveTolerance),
+        std::move(adaptiveAnchor)));
+}
+
+struct Synth::ParameterPointers
+{
+    struct Oscillator
+    {
+        juce::AudioParameterFloat*  gain = nullptr;
+        juce::AudioParameterFloat*  detune = nullptr;
+        juce::AudioParameterChoice* wave_form = nullptr;
+        juce::AudioParameterFloat*  gainA = nullptr;
+        juce::AudioParameterFloat*  detuneA = nullptr;
+        juce::AudioParameterChoice* wave_formA = nullptr;
+        juce::AudioParameterChoice* lfoModeA = nullptr;
+        juce::AudioParameterChoice* lfoSyncA = nullptr;
+        juce::AudioParameterFloat*  attackA = nullptr;
+        juce::AudioParameterFloat*  decayA = nullptr;
+        juce::AudioParameterFloat*  sustainA = nullptr;
+        juce::AudioParameterFloat*  releaseA = nullptr;
+    };
+
+    Oscillator                 oscillators[ParameterSnapshot::maxOscillators];
+    juce::AudioParameterFloat* attack = nullptr;
+    juce::AudioParameterFloat* decay = nullptr;
+    juce::AudioParameterFloat* sustain = nullptr;
+    juce::AudioParameterFloat* release = nullptr;
+    juce::AudioParameterFloat* gain = nullptr;
+    juce::AudioParameterBool*  voiceBank = nullptr;
+    juce::AudioParameterChoice* interpolation = nullptr;
+    juce::AudioParameterChoice* envelopeCurve = nullptr;
+    juce::AudioParameterInt*    lfoControlInterval = nullptr;
+    juce::AudioParameterInt*    renderThreads = nullptr;  // read on the message thread
+    juce::AudioParameterInt*    polyphony = nullptr;      // read when the sample rate is set
+    juce::AudioParameterChoice* stealPolicy = nullptr;
+    juce::AudioParameterFloat*  silenceThreshold = nullptr;
+    juce::AudioParameterBool*   adaptiveQuality = nullptr;
+    juce::AudioParameterFloat*  tuningGlide = nullptr;
+    juce::AudioParameterBool*   adaptiveTuning = nullptr;
+    juce::AudioParameterFloat*  adaptiveDrift = nullptr;
+    juce::AudioParameterFloat*  adaptiveTolerance = nullptr;
+    juce::AudioParameterChoice* adaptiveAnchor = nullptr;
+};
+
+Synth::Synth(const EngineContext& contextToUse)
+    : wavetables(WavetableBank::getShared()),
+      context(contextToUse),
+      globalLfo(parameterSnapshot, *wavetables, internalBlockSize)
+{
+    // the mapper GUI edits the mappings on the message thread, so that is where they are read
+    startTimerHz(30);
+}
+
+Synth::~Synth()
+{
+    stopTimer();
+}
+
+void Synth::attachParameters(juce::AudioProcessorValueTreeState& state)
+{
+    jassert(numOscillators <= ParameterSnapshot::maxOscillators);
+
+    auto pointers = std::make_unique<ParameterPointers>();
+    for (int i = 0; i < numOscillators; ++i)
+    {
+        auto& osc = pointers->oscillators[i];
+        osc.gain = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("osc" + juce::String(i)));
+        osc.detune = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("detune" + juce::String(i)));
+        osc.wave_form = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter("wave_form" + juce::String(i)));
+        osc.gainA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("oscA" + juce::String(i)));
+        osc.detuneA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("detuneA" + juce::String(i)));
+        osc.wave_formA = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter("wave_formA" + juce::String(i)));
+        osc.lfoModeA = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter("lfoModeA" + juce::String(i)));
+        osc.lfoSyncA = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter("lfoSyncA" + juce::String(i)));
+        osc.attackA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("attackA" + juce::String(i)));
+        osc.decayA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("decayA" + juce::String(i)));
+        osc.sustainA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("sustainA" + juce::String(i)));
+        osc.releaseA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("releaseA" + juce::String(i)));
+        jassert(osc.gain && osc.detune && osc.wave_form && osc.gainA && osc.detuneA && osc.wave_formA
+            && osc.lfoModeA && osc.lfoSyncA && osc.attackA && osc.decayA && osc.sustainA && osc.releaseA);
+    }
+
+    pointers->attack = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramAttack));
+    jassert(pointers->attack);
+    pointers->decay = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramDecay));
+    jassert(pointers->decay);
+    pointers->sustain = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramSustain));
+    jassert(pointers->sustain);
+    pointers->release = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramRelease));
+    jassert(pointers->release);
+    pointers->gain = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramGain));
+    jassert(pointers->gain);
+    pointers->voiceBank = dynamic_cast<juce::AudioParameterBool*>(state.getParameter(IDs::paramVoiceBank));
+    jassert(pointers->voiceBank);
+    pointers->interpolation = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter(IDs::paramInterpolation));
+    jassert(pointers->interpolation);
+    pointers->envelopeCurve = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter(IDs::paramEnvelopeCurve));
+    jassert(pointers->envelopeCurve);
+    pointers->lfoControlInterval = dynamic_cast<juce::AudioParameterInt*>(state.getParameter(IDs::paramLfoControlInterval));
+    jassert(pointers->lfoControlInterval);
+    pointers->renderThreads = dynamic_cast<juce::AudioParameterInt*>(state.getParameter(IDs::paramRenderThreads));
+    jassert(pointers->renderThreads);
+    pointers->polyphony = dynamic_cast<juce::AudioParameterInt*>(state.getParameter(IDs::paramPolyphony));
+    jassert(pointers->polyphony);
+    pointers->stealPolicy = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter(IDs::paramStealPolicy));
+    jassert(pointers->stealPolicy);
+    pointers->silenceThreshold = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramSilenceThreshold));
+    jassert(pointers->silenceThreshold);
+    pointers->adaptiveQuality = dynamic_cast<juce::AudioParameterBool*>(state.getParameter(IDs::paramAdaptiveQuality));
+    jassert(pointers->adaptiveQuality);
+    pointers->tuningGlide = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramTuningGlide));
+    jassert(pointers->tuningGlide);
+    pointers->adaptiveTuning = dynamic_cast<juce::AudioParameterBool*>(state.getParameter(IDs::paramAdaptiveTuning));
+    pointers->adaptiveDrift = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramAdaptiveDrift));
+    pointers->adaptiveTolerance = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramAdaptiveTolerance));
+    pointers->adaptiveAnchor = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter(IDs::paramAdaptiveAnchor));
+    jassert(pointers->adaptiveTuning && pointers->adaptiveDrift && pointers->adaptiveTolerance && pointers->adaptiveAnchor);
+
+    parameterPointers = std::move(pointers);
+    parameterSnapshotPrimed = false;
+}
+
+void Synth::updateParameters(int numSamples)
+{
+    if (parameterPointers == nullptr)
+        return;
+
+    // gains glide towards their targets with a one-pole stepped once per block
+    const auto sampleRate = getSampleRate();
+    const auto coefficient = parameterSnapshotPrimed && sampleRate > 0.0
+        ? float(1.0 - std::exp(-numSamples / (parameterSmoothingSeconds * sampleRate)))
+        : 1.0f;
+
+    auto smooth = [coefficient](float& value, float target)
+    {
+        value += (target - value) * coefficient;
+        if (std::abs(target - value) < 1.0e-5f)
+            value = target;
+    };
+
+    auto& source = *parameterPointers;
+    auto& snapshot = parameterSnapshot;
+
+    for (int i = 0; i < numOscillators; ++i)
+    {
+        auto& from = source.oscillators[i];
+        auto& osc = snapshot.oscillators[i];
+        smooth(osc.gain, from.gain->get());
+        osc.detune = from.detune->get();
+        osc.waveForm = from.wave_form->getIndex();
+        smooth(osc.gainA, from.gainA->get());
+        osc.detuneA = from.detuneA->get();
+        osc.waveFormA = from.wave_formA->getIndex();
+        osc.lfoGlobal = from.lfoModeA->getIndex() == 1;
+        osc.lfoSync = from.lfoSyncA->getIndex();
+        const auto beats = GlobalLfo::getBeatsPerCycle(osc.lfoSync);
+        osc.lfoFrequency = beats > 0.0 ? float(hostBpm / (60.0 * beats)) : osc.detuneA;
+        osc.envelope.attack = from.attackA->get();
+        osc.envelope.decay = from.decayA->get();
+        osc.envelope.sustain = from.sustainA->get();
+        osc.envelope.release = from.releaseA->get();
+    }
+
+    snapshot.adsr.attack = source.attack->get();
+    snapshot.adsr.decay = source.decay->get();
+    snapshot.adsr.sustain = source.sustain->get();
+    snapshot.adsr.release = source.release->get();
+    smooth(snapshot.gain, source.gain->get());
+
+    // engine settings apply from this block on
+    voiceBankEnabled = source.voiceBank->get();
+    // setInterpolation keeps the quality governor's ceiling
+    const auto newInterpolation = (WavetableBank::Interpolation) source.interpolation->getIndex();
+    if (newInterpolation != interpolation)
+        setInterpolation(newInterpolation);
+    const auto newCurve = (EnvelopeGenerator::Curve) source.envelopeCurve->getIndex();
+    if (newCurve != envelopeCurve)
+        setEnvelopeCurve(newCurve);
+    if (source.lfoControlInterval->get() != lfoControlInterval)
+        setLfoControlInterval(source.lfoControlInterval->get());
+    stealPolicy = (VoiceAllocator::StealPolicy) source.stealPolicy->getIndex();
+    if (source.silenceThreshold->get() != silenceThresholdDb)
+        setSilenceThreshold(source.silenceThreshold->get());
+    // an offline render may take as long as it needs, so it always renders at full quality
+    const auto adaptiveQualityWanted = source.adaptiveQuality->get() && !nonRealtime;
+    if (adaptiveQualityWanted != adaptiveQualityEnabled)
+        setAdaptiveQualityEnabled(adaptiveQualityWanted);
+    setTuningGlide(source.tuningGlide->get());
+
+    if (source.adaptiveTuning->get() != adaptiveTuningEnabled)
+        setAdaptiveTuningEnabled(source.adaptiveTuning->get());
+
+    AdaptiveTuning::Settings adaptiveSettings;
+    adaptiveSettings.maxDriftCents = source.adaptiveDrift->get();
+    adaptiveSettings.toleranceCents = source.adaptiveTolerance->get();
+    adaptiveSettings.anchor = (AdaptiveTuning::Anchor) source.adaptiveAnchor->getIndex();
+
+    // a change forces the held chord to be analysed again
+    const auto& currentSettings = adaptiveTuning.getSettings();
+    if (adaptiveSettings.maxDriftCents != currentSettings.maxDriftCents
+        || adaptiveSettings.toleranceCents != currentSettings.toleranceCents
+        || adaptiveSettings.anchor != currentSettings.anchor)
+        setAdaptiveTuningSettings(adaptiveSettings);
+
+    parameterSnapshotPrimed = true;
+    globalLfo.startBlock(hostPpqPosition, hostPlaying);
+}
+
+void Synth::updateTransport(juce::AudioPlayHead* playHead)
+{
+    juce::AudioPlayHead::CurrentPositionInfo position;
+    if (playHead == nullptr || !playHead->getCurrentPosition(position))
+    {
+        hostPlaying = false;
+        return;
+    }
+
+    if (position.bpm > 0.0)
+        hostBpm = position.bpm;
+    hostPpqPosition = position.ppqPosition;
+    hostPlaying = position.isPlaying;
+}
+
+void Synth::updateTuning()
+{
+    const auto changes = tuning.pinLatest();
+
+    // a mapping picked in the GUI takes over from a program change; a rebuilt bank keeps it
+    if ((changes & TuningStore::tableChanged) != 0)
+        selectedTuning = -1;
+    else if ((changes & TuningStore::bankChanged) == 0 || selectedTuning < 0)
+        return;
+    else if (!tuning.select(selectedTuning))
+        selectedTuning = -1;
+
+    retuneVoices();
+}
+
+void Synth::retuneVoices()
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto* voice : voices)
+        if (voice->isVoiceActive())
+            static_cast<Voice*>(voice)->retune(tuningGlideSeconds);
+}
+
+void Synth::render(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& midi, int startSample, int numSamples)
+{
+    render(outputAudio, midi, nullptr, 0, startSample, numSamples);
+}
+
+void Synth::render(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& midi,
+                   const UniversalMidi::Packet* packets, int numPackets, int startSample, int numSamples)
+{
+    // juce::Synthesiser wraps every event in a MidiMessage, which allocates for
+    // SysEx and can't hold a MIDI 2.0 packet, so tuning messages and packets are
+    // applied here and the block is split at each
+    const auto endSample = startSample + numSamples;
+    auto position = startSample;
+    playableMidi.clear();
+
+    // events at the split point stay queued, so they still start the next chunk
+    auto renderTo = [&](int sample)
+    {
+        const auto at = juce::jlimit(position, endSample, sample);
+        if (at == position)
+            return;
+
+        renderNextBlock(outputAudio, playableMidi, position, at - position);
+        playableMidi.clear();
+        position = at;
+    };
+
+    auto packet = 0;
+    for (const auto metadata : midi)
+    {
+        for (; packet < numPackets && packets[packet].samplePosition < metadata.samplePosition; ++packet)
+        {
+            renderTo(packets[packet].samplePosition);
+            applyUniversalPacket(packets[packet]);
+        }
+
+        if (!MtsSysEx::isTuningMessage(metadata.data, metadata.numBytes))
+        {
+            playableMidi.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+            continue;
+        }
+
+        renderTo(metadata.samplePosition);
+        applyTuningMessage(metadata.data, metadata.numBytes);
+    }
+
+    for (; packet < numPackets; ++packet)
+    {
+        renderTo(packets[packet].samplePosition);
+        applyUniversalPacket(packets[packet]);
+    }
+
+    renderTo(endSample);
+}
+
+void Synth::applyTuningMessage(const juce::uint8* data, int size)
+{
+    const juce::ScopedLock sl(lock);
+
+    const auto sampleRate = getSampleRate();
+    std::bitset<TuningTable::numKeys> retuned;
+    MtsSysEx::parse(data, size, [this, sampleRate, &retuned](int key, double frequency)
+    {
+        tuning.retune(key, frequency, sampleRate);
+        retuned.set((size_t) key);
+    });
+
+    // notes already sounding on a retuned key change pitch from this sample
+    for (auto* voice : voices)
+    {
+        const auto note = voice->getCurrentlyPlayingNote();
+        if (note >= 0 && retuned[(size_t) note])
+            static_cast<Voice*>(voice)->retune();
+    }
+}
+
+void Synth::applyUniversalPacket(const UniversalMidi::Packet& packet)
+{
+    using UMP = UniversalMidi;
+    const juce::ScopedLock sl(lock);
+
+    // a MIDI 1.0 channel voice packet holds the bytestream message in its first word,
+    // which fits inside a MidiMessage, so this doesn't allocate
+    auto handleMidi1 = [this](const juce::universal_midi_packets::View& view)
+    {
+        if (UMP::Utils::getMessageType(view[0]) != UMP::midi1ChannelVoice)
+            return;
+
+        const juce::uint8 bytes[] = { UMP::Utils::U8<1>::get(view[0]), UMP::Utils::U8<2>::get(view[0]), UMP::Utils::U8<3>::get(view[0]) };
+        handleMidiEvent(juce::MidiMessage(bytes, juce::MidiMessage::getMessageLengthFromFirstByte(bytes[0])));
+    };
+
+    if (UMP::getMessageType(packet) != UMP::midi2ChannelVoice)
+    {
+        handleMidi1(UMP::getView(packet));
+        return;
+    }
+
+    const auto channel = UMP::getChannel(packet);
+    const auto note = UMP::getNoteNumber(packet);
+    switch (UMP::getStatus(packet))
+    {
+        case UMP::noteOn:
+        {
+            // MIDI 2.0 has no note-on at zero velocity: it is a quiet note, not a note-off
+            const auto hasPitch = UMP::getAttributeType(packet) == UMP::pitchAttribute;
+            nextNoteFrequency = hasPitch ? UMP::getFrequency(UMP::getPitch7_9(packet)) : 0.0;
+            noteOn(channel, note, UMP::getVelocity(packet));
+            nextNoteFrequency = 0.0;
+            break;
+        }
+
+        case UMP::noteOff:
+            noteOff(channel, note, UMP::getVelocity(packet), true);
+            break;
+
+        case UMP::registeredPerNoteController:
+            if (auto* voice = findPlayingVoice(channel, note))
+            {
+                if (UMP::getIndex(packet) == UMP::pitchController)
+                    voice->setNoteFrequency(UMP::getFrequency(UMP::getPitch7_25(packet)));
+                else if (UMP::getIndex(packet) == 74)
+                    voice->setTimbre(float(UMP::getBipolarData(packet)));
+            }
+            break;
+
+        case UMP::perNotePitchBend:
+            if (auto* voice = findPlayingVoice(channel, note))
+                voice->setNoteBend(UMP::getBipolarData(packet) * mpeNotePitchBendRange);
+            break;
+
+        case UMP::perNoteManagement:
+            if (UMP::isReset(packet))
+            {
+                if (auto* voice = findPlayingVoice(channel, note))
+                {
+                    voice->setNoteFrequency(0.0);
+                    voice->setNoteBend(0.0);
+                }
+            }
+            break;
+
+        case UMP::assignablePerNoteController:
+            break;
+
+        default:
+            // pressure, controllers, RPNs, program changes and pitch bend mean the same at
+            // MIDI 1.0 resolution; an RPN arrives as the CC 101/100/6/38 sequence handleController reads
+            juce::universal_midi_packets::Conversion::toMidi1(UMP::getView(packet), handleMidi1);
+            break;
+    }
+}
+
+Synth::Voice* Synth::findPlayingVoice(int midiChannel, int midiNoteNumber)
+{
+    for (auto* voice : voices)
+        if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel(midiChannel))
+            return static_cast<Voice*>(voice);
+
+    return nullptr;
+}
+
+void Synth::publishTuning()
+{
+    auto bankStale = false;
+    {
+        const juce::ScopedLock sl(tuningLock);
+
+        const auto group = context.mappingGroup.load();
+        if (group != tuningGroup
+            || context.importedTunings[group] != tuningImport
+            || !isSameMapping(context.microtonalMappings[group], tuningSource))
+            compileTuning(group);
+
+        bankStale = isBankStale();
+    }
+
+    // compileBank takes the lock only to copy its sources and to publish
+    if (bankStale)
+        compileBank();
+}
+
+bool Synth::isBankStale() const
+{
+    if (tuningLibrary != nullptr && tuningLibrary->getGeneration() != bankLibraryGeneration)
+        return true;
+
+    for (int group = 0; group < EngineContext::numPresets; ++group)
+        if (context.importedTunings[group] != bankImports[group]
+            || !isSameMapping(context.microtonalMappings[group], bankSources[group]))
+            return true;
+
+    return false;
+}
+
+void Synth::compileTuning(int group)
+{
+    const juce::ScopedLock sl(tuningLock);
+
+    tuning.publish(compileGroup(context.microtonalMappings[group], context.importedTunings[group].get(), tuningSampleRate.load()));
+
+    tuningGroup = group;
+    tuningSource = context.microtonalMappings[group];
+    tuningImport = context.importedTunings[group];
+}
+
+std::unique_ptr<TuningTable> Synth::compileGroup(const MicrotonalConfig& mapping, const CompiledTuning* import, double sampleRate)
+{
+    auto table = std::make_unique<TuningTable>();
+    if (import != nullptr)
+        table->compile(*import, sampleRate);
+    else
+        table->compile(mapping, sampleRate);
+    return table;
+}
+
+void Synth::compileBank()
+{
+    // copy the sources under the lock, then compile without it, so the GUI and
+    // publishTuning never wait on a rebuild
+    MicrotonalConfig sources[EngineContext::numPresets];
+    std::shared_ptr<const CompiledTuning> imports[EngineContext::numPresets];
+    juce::StringArray names;
+    std::vector<std::shared_ptr<const CompiledTuning>> libraryTunings;
+    auto libraryGeneration = -1;
+    auto sampleRate = 0.0;
+    auto build = 0;
+    {
+        const juce::ScopedLock sl(tuningLock);
+
+        sampleRate = tuningSampleRate.load();
+        for (int group = 0; group < EngineContext::numPresets; ++group)
+        {
+            sources[group] = context.microtonalMappings[group];
+            imports[group] = context.importedTunings[group];
+            names.add(context.microtonalPresetNames[group]);
+        }
+
+        if (tuningLibrary != nullptr)
+        {
+            libraryGeneration = tuningLibrary->getGeneration();
+            libraryTunings = tuningLibrary->getTunings();
+        }
+
+        build = ++bankBuilds;
+    }
+
+    // library tunings stay shared and sample rate independent; selecting one compiles it
+    auto bank = std::make_unique<TuningBank>(sampleRate);
+    for (int group = 0; group < EngineContext::numPresets; ++group)
+        bank->add(compileGroup(sources[group], imports[group].get(), sampleRate), names[group]);
+    bank->addLibrary(std::move(libraryTunings));
+
+    const juce::ScopedLock sl(tuningLock);
+
+    // a build started since this one has newer sources, or a newer sample rate
+    if (build != bankBuilds)
+        return;
+
+    for (int group = 0; group < EngineContext::numPresets; ++group)
+    {
+        bankSources[group] = sources[group];
+        bankImports[group] = imports[group];
+    }
+
+    bankLibraryGeneration = libraryGeneration;
+    tuning.publishBank(std::move(bank));
+}
+
+void Synth::setTuningLibrary(std::shared_ptr<TuningLibrary> library)
+{
+    const juce::ScopedLock sl(tuningLock);
+    tuningLibrary = std::move(library);
+    bankLibraryGeneration = -1;
+}
+
+void Synth::setAdaptiveTuningEnabled(bool shouldBeEnabled)
+{
+    const juce::ScopedLock sl(lock);
+    adaptiveTuningEnabled = shouldBeEnabled;
+    numAdaptiveNotes = -1;
+
+    if (!shouldBeEnabled)
+        for (auto* voice : voices)
+            static_cast<Voice*>(voice)->setAdaptiveOffset(0.0);
+}
+
+void Synth::setAdaptiveTuningSettings(const AdaptiveTuning::Settings& newSettings)
+{
+    const juce::ScopedLock sl(lock);
+    adaptiveTuning.setSettings(newSettings);
+    numAdaptiveNotes = -1;
+}
+
+void Synth::updateAdaptiveTuning()
+{
+    static_assert(AdaptiveTuning::maxNotes >= VoiceAllocator::maxVoices, "every voice must fit in one analysis");
+
+    if (!isAllocatorInSync())
+        return;
+
+    // the chord is what the held keys play; released notes keep the offset they had
+    int voiceIndices[VoiceAllocator::maxVoices];
+    double frequencies[VoiceAllocator::maxVoices];
+    auto count = 0;
+    for (auto v = allocator.getOldest(); v != VoiceAllocator::none; v = allocator.getNext(v))
+    {
+        const auto* voice = static_cast<Voice*>(voices.getUnchecked(v));
+        if (voice->isSounding() && !voice->isReleasing() && voice->getTunedFrequency() > 0.0)
+        {
+            voiceIndices[count] = v;
+            frequencies[count++] = voice->getTunedFrequency();
+        }
+    }
+
+    // a held chord is analysed once, not every block
+    auto unchanged = count == numAdaptiveNotes;
+    for (int i = 0; unchanged && i < count; ++i)
+        unchanged = voiceIndices[i] == adaptiveVoices[(size_t) i] && frequencies[i] == adaptiveFrequencies[(size_t) i];
+
+    if (unchanged)
+        return;
+
+    numAdaptiveNotes = count;
+    std::copy(voiceIndices, voiceIndices + count, adaptiveVoices.begin());
+    std::copy(frequencies, frequencies + count, adaptiveFrequencies.begin());
+
+    adaptiveTuning.analyse(adaptiveFrequencies.data(), count, adaptiveOffsets.data());
+    for (int i = 0; i < count; ++i)
+        static_cast<Voice*>(voices.getUnchecked(adaptiveVoices[(size_t) i]))->setAdaptiveOffset(adaptiveOffsets[(size_t) i]);
+}
+
+void Synth::timerCallback()
+{
+    publishTuning();
+    applyRenderThreads();
+}
+
+void Synth::applyRenderThreads()
+{
+    if (parameterPointers != nullptr && parameterPointers->renderThreads->get() != numRenderThreads)
+        setRenderThreads(parameterPointers->renderThreads->get());
+}
+
+void Synth::setInterpolation(WavetableBank::Interpolation newInterpolation)
+{
+    interpolation = newInterpolation;
+    applyQualityTier();
+}
+
+void Synth::setEnvelopeCurve(EnvelopeGenerator::Curve newCurve)
+{
+    envelopeCurve = newCurve;
+    for (auto* voice : voices)
+        static_cast<Voice*>(voice)->setEnvelopeCurve(newCurve);
+}
+
+void Synth::setLfoControlInterval(int numSamples)
+{
+    lfoControlInterval = juce::jlimit(1, internalBlockSize, numSamples);
+    for (auto* voice : voices)
+        static_cast<Voice*>(voice)->setLfoControlInterval(lfoControlInterval);
+}
+
+void Synth::setVoiceBankEnabled(bool shouldBeEnabled)
+{
+    voiceBankEnabled = shouldBeEnabled;
+}
+
+void Synth::setRenderThreads(int numWorkers)
+{
+    numRenderThreads = juce::jmax(0, numWorkers);
+
+    std::unique_ptr<VoiceRenderPool> newPool;
+    if (numWorkers > 0)
+        newPool = std::make_unique<VoiceRenderPool>(numWorkers);
+
+    {
+        const juce::ScopedLock sl(lock);
+        std::swap(renderPool, newPool);
+    }
+
+    // the old pool's threads are joined here, outside the render lock
+}
+
+void Synth::setPolyphony(int numVoices)
+{
+    polyphony = juce::jlimit(1, VoiceAllocator::maxVoices, numVoices);
+}
+
+Synth::Voice* Synth::createVoice()
+{
+    auto* voice = new Voice(parameterSnapshot, *wavetables, globalLfo, tuning);
+    voice->setInterpolation(renderInterpolation);
+    voice->setPartialFloor(QualityGovernor::getTier(0).partialFloor);
+    voice->setSilenceLevel(silenceLevel);
+    voice->setEnvelopeCurve(envelopeCurve);
+    voice->setLfoControlInterval(lfoControlInterval);
+    return voice;
+}
+
+void Synth::setAdaptiveQualityEnabled(bool shouldBeEnabled)
+{
+    adaptiveQualityEnabled = shouldBeEnabled;
+    qualityGovernor.reset();
+    applyQualityTier();
+}
+
+void Synth::setSilenceThreshold(float decibels)
+{
+    silenceThresholdDb = decibels;
+    silenceLevel = juce::Decibels::decibelsToGain(decibels);
+    for (auto* voice : voices)
+        static_cast<Voice*>(voice)->setSilenceLevel(silenceLevel);
+}
+
+bool Synth::isIdle() const
+{
+    if (isAllocatorInSync())
+        return allocator.getNumActive() == 0;
+
+    for (auto* voice : voices)
+        if (voice->isVoiceActive())
+            return false;
+    return true;
+}
+
+void Synth::skipIdleBlock(int numSamples)
+{
+    globalLfo.skip(numSamples);
+}
+
+void Synth::registerBlockTime(double milliseconds, int numSamples)
+{
+    if (adaptiveQualityEnabled && !nonRealtime && qualityGovernor.registerBlock(milliseconds, numSamples))
+        applyQualityTier();
+}
+
+void Synth::applyQualityTier()
+{
+    const auto& tier = adaptiveQualityEnabled ? qualityGovernor.getTier() : QualityGovernor::getTier(0);
+
+    // the tier only ever lowers the interpolation the user picked
+    renderInterpolation = std::min(interpolation, tier.interpolation);
+    voiceLimit = juce::jmax(1, juce::roundToInt(polyphony * tier.voiceShare));
+
+    for (auto* voice : voices)
+    {
+        static_cast<Voice*>(voice)->setInterpolation(renderInterpolation);
+        static_cast<Voice*>(voice)->setPartialFloor(tier.partialFloor);
+    }
+}
+
+void Synth::setCurrentPlaybackSampleRate(double sampleRate)
+{
+    // changing the voice count allocates, so the parameter only takes effect here
+    if (parameterPointers != nullptr)
+        setPolyphony(parameterPointers->polyphony->get());
+
+    if (getNumVoices() != polyphony)
+    {
+        clearVoices();
+        for (int i = 0; i < polyphony; ++i)
+            addVoice(createVoice());
+    }
+
+    juce::Synthesiser::setCurrentPlaybackSampleRate(sampleRate);
+    allNotesOff(0, false);
+    allocator.setNumVoices(getNumVoices());
+    qualityGovernor.setSampleRate(sampleRate);
+    applyQualityTier();
+    tuningSampleRate.store(sampleRate);
+    compileTuning(context.mappingGroup.load());
+    compileBank();
+    globalLfo.setSampleRate(sampleRate);
+    applyRenderThreads();
+
+    voiceScratch.resize((size_t) getNumVoices());
+    for (auto& scratch : voiceScratch)
+        scratch.setSize(1, internalBlockSize);
+    parallelVoices.reserve((size_t) getNumVoices());
+    playableMidi.ensureSize(4096);
+
+#if JUCE_USE_SIMD
+    // slot = partial * stride + voice, so each register holds one partial of neighbouring voices
+    voiceBankStride = (getNumVoices() + PartialBank::lanes - 1) / PartialBank::lanes * PartialBank::lanes;
+    voiceBank = std::make_unique<PartialBank>(numOscillators * voiceBankStride, internalBlockSize);
+    voiceBankActivePartials.assign((size_t) getNumVoices(), 0);
+#endif
+}
+
+void Synth::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    limitVoices();
+
+    // the global LFOs are rendered once per internal block, so every voice
+    // renders exactly that block and reads the shared buffers from their start
+    while (numSamples > 0)
+    {
+        auto left = std::min(numSamples, internalBlockSize);
+        if (adaptiveTuningEnabled)
+            updateAdaptiveTuning();
+
+        globalLfo.render(left, lfoControlInterval);
+        renderVoiceBlock(outputAudio, startSample, left);
+
+        startSample += left;
+        numSamples -= left;
+    }
+
+    reclaimVoices();
+}
+
+void Synth::renderVoiceBlock(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    if (renderPool != nullptr && numSamples >= parallelMinimumSamples
+        && (int) voiceScratch.size() >= getNumVoices() && isAllocatorInSync())
+    {
+        parallelVoices.clear();
+        for (auto v = allocator.getOldest(); v != VoiceAllocator::none; v = allocator.getNext(v))
+            if (static_cast<Voice*>(voices.getUnchecked(v))->isSounding())
+                parallelVoices.push_back(v);
+
+        if ((int) parallelVoices.size() >= parallelMinimumVoices)
+        {
+            renderVoicesInParallel(outputAudio, startSample, numSamples);
+            return;
+        }
+    }
+
+#if JUCE_USE_SIMD
+    if (voiceBankEnabled && voiceBank != nullptr && getNumVoices() <= voiceBankStride)
+    {
+        int numSounding = 0;
+        for (auto* voice : voices)
+            if (static_cast<Voice*>(voice)->isSounding())
+                ++numSounding;
+
+        if (numSounding >= PartialBank::lanes)
+        {
+            renderVoiceBank(outputAudio, startSample, numSamples);
+            return;
+        }
+    }
+#endif
+
+    if (!isAllocatorInSync())
+    {
+        juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+        return;
+    }
+
+    // only voices the allocator handed out can be sounding, so idle ones cost nothing
+    for (auto v = allocator.getOldest(); v != VoiceAllocator::none; v = allocator.getNext(v))
+        voices.getUnchecked(v)->renderNextBlock(outputAudio, startSample, numSamples);
+}
+
+void Synth::noteOn(int midiChannel, int midiNoteNumber, float velocity)
+{
+    if (!isAllocatorInSync())
+    {
+        juce::Synthesiser::noteOn(midiChannel, midiNoteNumber, velocity);
+        return;
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    for (auto* sound : sounds)
+    {
+        if (!sound->appliesToNote(midiNoteNumber) || !sound->appliesToChannel(midiChannel))
+            continue;
+
+        // a key still ringing under the pedals is let go before it is struck again
+        auto ringing = allocator.findVoice(midiChannel, midiNoteNumber);
+        if (ringing != VoiceAllocator::none)
+        {
+            auto* voice = voices.getUnchecked(ringing);
+            if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel(midiChannel))
+                stopVoice(voice, 1.0f, true);
+        }
+
+        auto v = findVoiceToStart(midiChannel, midiNoteNumber);
+        if (v == VoiceAllocator::none)
+            continue;
+
+        // MPE controllers send a note's bend, pressure and timbre before its note-on
+        auto* voice = static_cast<Voice*>(voices.getUnchecked(v));
+        const auto& channel = channelExpressions[(midiChannel - 1) & 15];
+        voice->setPitchBendRange(channel.pitchBendRange);
+        voice->setMasterBend(masterBend);
+        voice->setPressure(channel.pressure / 127.0f);
+        voice->setTimbre(juce::jlimit(-1.0f, 1.0f, (channel.timbre - 64) / 63.0f));
+        voice->setNoteBend(0.0);
+        voice->setNoteFrequency(nextNoteFrequency);
+
+        allocator.activate(v, midiChannel, midiNoteNumber);
+        startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+    }
+}
+
+void Synth::noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff)
+{
+    if (!isAllocatorInSync())
+    {
+        juce::Synthesiser::noteOff(midiChannel, midiNoteNumber, velocity, allowTailOff);
+        return;
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    auto v = allocator.findVoice(midiChannel, midiNoteNumber);
+    if (v == VoiceAllocator::none)
+        return;
+
+    auto* voice = voices.getUnchecked(v);
+    auto* sound = voice->getCurrentlyPlayingSound().get();
+    if (voice->getCurrentlyPlayingNote() != midiNoteNumber || !voice->isPlayingChannel(midiChannel)
+        || sound == nullptr || !sound->appliesToNote(midiNoteNumber) || !sound->appliesToChannel(midiChannel))
+        return;
+
+    voice->setKeyDown(false);
+
+    if (!(voice->isSustainPedalDown() || voice->isSostenutoPedalDown()))
+        stopVoice(voice, velocity, allowTailOff);
+}
+
+void Synth::handlePitchWheel(int midiChannel, int wheelValue)
+{
+    if (midiChannel != mpeMasterChannel)
+    {
+        juce::Synthesiser::handlePitchWheel(midiChannel, wheelValue);
+        return;
+    }
+
+    // an MPE master channel bends every note in the zone
+    const juce::ScopedLock sl(lock);
+    lastPitchWheelValues[midiChannel - 1] = wheelValue;
+    masterBend = Voice::getBendFromPitchWheel(wheelValue, channelExpressions[midiChannel - 1].pitchBendRange);
+    for (auto* voice : voices)
+        static_cast<Voice*>(voice)->setMasterBend(masterBend);
+}
+
+void Synth::handleController(int midiChannel, int controllerNumber, int controllerValue)
+{
+    if (midiChannel >= 1 && midiChannel <= 16)
+    {
+        auto& channel = channelExpressions[midiChannel - 1];
+        switch (controllerNumber)
+        {
+            case 74:   channel.timbre = controllerValue; break;
+            case 0:    channel.bankSelect = (controllerValue << 7) | (channel.bankSelect & 0x7f); break;
+            case 32:   channel.bankSelect = (channel.bankSelect & ~0x7f) | controllerValue; break;
+            case 101:  channel.parameterNumber = (controllerValue << 7) | (channel.parameterNumber & 0x7f); break;
+            case 100:  channel.parameterNumber = (channel.parameterNumber & ~0x7f) | controllerValue; break;
+            case 98:
+            case 99:   channel.parameterNumber = 0x3fff; break;  // NRPNs aren't ours
+            case 6:
+                if (channel.parameterNumber == 0)
+                    setPitchBendRange(midiChannel, controllerValue);
+                else if (channel.parameterNumber == 6 && (midiChannel == 1 || midiChannel == 16))
+                    configureMpeZone(midiChannel, controllerValue);
+                break;
+            default:
+                break;
+        }
+    }
 
+    juce::Synthesiser::handleController(midiChannel, controllerNumber, controllerValue);
+}
 
-void Synth::addADSRParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+void Synth::handleChannelPressure(int midiChannel, int channelPressureValue)
 {
-    auto attack = std::make_unique<juce::AudioParameterFloat>(IDs::paramAttack, "Attack", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.10f);
-    auto decay = std::make_unique<juce::AudioParameterFloat>(IDs::paramDecay, "Decay", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.10f);
-    auto sustain = std::make_unique<juce::AudioParameterFloat>(IDs::paramSustain, "Sustain", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f);
-    auto release = std::make_unique<juce::AudioParameterFloat>(IDs::paramRelease, "Release", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.10f);
+    if (midiChannel >= 1 && midiChannel <= 16)
+        channelExpressions[midiChannel - 1].pressure = channelPressureValue;
 
-    auto group = std::make_unique<juce::AudioProcessorParameterGroup>("adsr", "ADRS", "|",
-        std::move(attack),
-        std::move(decay),
-        std::move(sustain),
-        std::move(release));
-    layout.add(std::move(group));
+    juce::Synthesiser::handleChannelPressure(midiChannel, channelPressureValue);
 }
 
-void Synth::addOvertoneParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+void Synth::handleProgramChange(int midiChannel, int programNumber)
 {
-    auto group = std::make_unique<juce::AudioProcessorParameterGroup>("oscillators", "Oscillators", "|");
-    for (int i = 0; i < Synth::numOscillators; ++i)
+    const juce::ScopedLock sl(lock);
+
+    const auto index = channelExpressions[(midiChannel - 1) & 15].bankSelect * 128 + programNumber;
+    if (!tuning.select(index))
+        return;
+
+    selectedTuning = index;
+    retuneVoices();
+}
+
+void Synth::setPitchBendRange(int midiChannel, int semitones)
+{
+    const juce::ScopedLock sl(lock);
+    channelExpressions[midiChannel - 1].pitchBendRange = semitones;
+
+    if (midiChannel == mpeMasterChannel)
     {
-        group->addChild(std::make_unique<juce::AudioParameterFloat>("osc" + juce::String(i), "Oscillator " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
-        group->addChild(std::make_unique<juce::AudioParameterFloat>("detune" + juce::String(i), "Detune " + juce::String(i), juce::NormalisableRange<float>(0.0625f, 16.0f, 0.0001f), 1.0f));
-		group->addChild(std::make_unique<juce::AudioParameterChoice>("wave_form" + juce::String(i), "wave_form " + juce::String(i),
-            juce::StringArray({ "Sin","Squ","Saw","Tri","Cu1","Cu2","Cu3","Cu4","Cu5","Cu6","Cu7" }),
-            0));
-        group->addChild(std::make_unique<juce::AudioParameterFloat>("oscA" + juce::String(i), "OscillatorA " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
-        group->addChild(std::make_unique<juce::AudioParameterFloat>("detuneA" + juce::String(i), "DetuneA " + juce::String(i), juce::NormalisableRange<float>(0.0625f, 16.0f, 0.0001f), 1.0f));
-        group->addChild(std::make_unique<juce::AudioParameterChoice>("wave_formA" + juce::String(i), "wave_formA " + juce::String(i),
-            juce::StringArray({ "Sin","Squ","Saw","Tri","Cu1","Cu2","Cu3","Cu4","Cu5","Cu6","Cu7" }),
-            0));
-        group->addChild(std::make_unique<juce::AudioParameterFloat>("attackA" + juce::String(i), "AttackA " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.00f));
-        group->addChild(std::make_unique<juce::AudioParameterFloat>("decayA" + juce::String(i), "DecayA " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.00f));
-        group->addChild(std::make_unique<juce::AudioParameterFloat>("sustainA" + juce::String(i), "SustainA " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f));
-        group->addChild(std::make_unique<juce::AudioParameterFloat>("releaseA" + juce::String(i), "ReleaseA " + juce::String(i), juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f));
+        handlePitchWheel(midiChannel, lastPitchWheelValues[midiChannel - 1]);
+        return;
+    }
 
-	}
+    for (auto* voice : voices)
+        if (voice->isPlayingChannel(midiChannel))
+            static_cast<Voice*>(voice)->setPitchBendRange(semitones);
+}
 
-    //instrumentNames.push_back("preset1");
-    //instrumentNames.push_back("preset2");
-    //instrumentNames.push_back("preset3");
+void Synth::configureMpeZone(int masterChannel, int numMemberChannels)
+{
+    const juce::ScopedLock sl(lock);
 
-    //auto groupInstruments = std::make_unique<juce::AudioProcessorParameterGroup>("instruments", "Instruments", "|");
-    //groupInstruments->addChild(std::make_unique<juce::AudioParameterChoice>("instrumentPreset", "Instrument_Preset", juce::StringArray({ "preset342", "preset54"}), 0));
+    if (numMemberChannels == 0 && (mpeMasterChannel == 0 || masterChannel != mpeMasterChannel))
+        return;
 
+    // MPE's defaults: 2 semitones on the master channel, 48 on the note channels
+    mpeMasterChannel = numMemberChannels > 0 ? masterChannel : 0;
+    for (int channel = 1; channel <= 16; ++channel)
+        setPitchBendRange(channel, mpeMasterChannel == 0 || channel == mpeMasterChannel ? defaultPitchBendRange
+                                                                                        : mpeNotePitchBendRange);
 
-    
-    
-    //layout.add(std::move(groupInstruments));
-    layout.add(std::move(group));
+    // no longer a master: its bend leaves every note
+    if (mpeMasterChannel == 0)
+    {
+        masterBend = 0.0;
+        for (auto* voice : voices)
+            static_cast<Voice*>(voice)->setMasterBend(masterBend);
+    }
+}
 
+void Synth::setMpeEnabled(bool shouldBeEnabled)
+{
+    configureMpeZone(shouldBeEnabled ? 1 : mpeMasterChannel, shouldBeEnabled ? 15 : 0);
 }
 
+int Synth::findVoiceToStart(int midiChannel, int midiNoteNumber)
+{
+    // voices whose release ended since the last block are still listed as active
+    if (allocator.getNumActive() >= voiceLimit)
+        reclaimVoices();
 
-void Synth::addGainParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
+    auto v = allocator.getNumActive() < voiceLimit ? allocator.allocate() : VoiceAllocator::none;
+
+    if (v != VoiceAllocator::none || !isNoteStealingEnabled())
+        return v;
+
+    switch (stealPolicy)
+    {
+        case VoiceAllocator::StealPolicy::sameNote:
+            v = allocator.findVoice(midiChannel, midiNoteNumber);
+            return v != VoiceAllocator::none ? v : allocator.getOldest();
+
+        case VoiceAllocator::StealPolicy::quietest:
+        {
+            auto quietestLevel = std::numeric_limits<float>::max();
+            for (auto candidate = allocator.getOldest(); candidate != VoiceAllocator::none; candidate = allocator.getNext(candidate))
+            {
+                auto level = static_cast<Voice*>(voices.getUnchecked(candidate))->getEnvelopeLevel();
+                if (level < quietestLevel)
+                {
+                    quietestLevel = level;
+                    v = candidate;
+                }
+            }
+            return v;
+        }
+
+        case VoiceAllocator::StealPolicy::oldest:
+        default:
+            return allocator.getOldest();
+    }
+}
+
+void Synth::reclaimVoices()
 {
-    auto gain = std::make_unique<juce::AudioParameterFloat>(IDs::paramGain, "Gain", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.70f);
+    if (!isAllocatorInSync())
+        return;
 
-    layout.add(std::make_unique<juce::AudioProcessorParameterGroup>("output", "Output", "|", std::move(gain)));
+    for (auto v = allocator.getOldest(); v != VoiceAllocator::none;)
+    {
+        auto next = allocator.getNext(v);
+        if (!voices.getUnchecked(v)->isVoiceActive())
+            allocator.release(v);
+        v = next;
+    }
 }
 
-//==============================================================================
+void Synth::limitVoices()
+{
+    if (!isAllocatorInSync())
+        return;
+
+    // when the quality tier lowers the limit, the oldest voices past it fade out
+    auto excess = allocator.getNumActive() - voiceLimit;
+    for (auto v = allocator.getOldest(); v != VoiceAllocator::none && excess > 0; v = allocator.getNext(v))
+    {
+        auto* voice = static_cast<Voice*>(voices.getUnchecked(v));
+        if (voice->isVoiceActive() && !voice->isReleasing())
+            stopVoice(voice, 0.0f, true);
+        --excess;
+    }
+}
 
-Synth::Sound::Sound(juce::AudioProcessorValueTreeState& stateToUse)
-    : state(stateToUse)
+void Synth::renderVoicesInParallel(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
 {
-    attack = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramAttack));
-    jassert(attack);
-    decay = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramDecay));
-    jassert(decay);
-    sustain = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramSustain));
-    jassert(sustain);
-    release = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramRelease));
-    jassert(release);
-    gain = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramGain));
-    jassert(gain);
+    parallelNumSamples = numSamples;
+    renderPool->run((int) parallelVoices.size(), renderVoiceJob, this);
+
+    // summing in voice order keeps the output identical to the serial path
+    for (auto v : parallelVoices)
+        outputAudio.addFrom(0, startSample, voiceScratch[(size_t) v], 0, 0, numSamples);
 }
 
-juce::ADSR::Parameters Synth::Sound::getADSR()
+void Synth::renderVoiceJob(void* context, int index)
 {
-    juce::ADSR::Parameters parameters;
-    parameters.attack = attack->get();
-    parameters.decay = decay->get();
-    parameters.sustain = sustain->get();
-    parameters.release = release->get();
-    return parameters;
+    auto& synth = *static_cast<Synth*>(context);
+    auto v = synth.parallelVoices[(size_t) index];
+    auto& scratch = synth.voiceScratch[(size_t) v];
+
+    scratch.clear(0, 0, synth.parallelNumSamples);
+    synth.voices.getUnchecked(v)->renderNextBlock(scratch, 0, synth.parallelNumSamples);
 }
 
-//==============================================================================
+#if JUCE_USE_SIMD
+void Synth::renderVoiceBank(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    auto* output = outputAudio.getWritePointer(0, startSample);
+
+    while (numSamples > 0)
+    {
+        auto left = std::min(numSamples, internalBlockSize);
+
+        for (int v = 0; v < getNumVoices(); ++v)
+        {
+            auto* voice = static_cast<Voice*>(voices.getUnchecked(v));
+            auto& activePartials = voiceBankActivePartials[(size_t) v];
 
-void Synth::Voice::loadcustomwave(const char* file, int i) {
-    juce::String filePath = juce::File::getCurrentWorkingDirectory().getFullPathName();
-    filePath += "\\custom_waves\\";
-    filePath += file;
-    FILE* fp = fopen(filePath.toRawUTF8(), "r");
-    if (fp != nullptr) {
-        float num;
-        while (fscanf(fp, "%f", &num) != EOF) {
-            cu_w[i].push_back(num);
-            cu_t[i] += 1.0;
+            if (voice->isSounding())
+            {
+                activePartials = voice->loadVoiceBankPartials(*voiceBank, v, voiceBankStride, left);
+            }
+            else
+            {
+                voice->clearPartials(*voiceBank, v, voiceBankStride);
+                activePartials = 0;
+            }
+        }
+
+        voiceBank->render(output, left, renderInterpolation, lfoControlInterval);
+
+        for (int v = 0; v < getNumVoices(); ++v)
+        {
+            auto* voice = static_cast<Voice*>(voices.getUnchecked(v));
+            voice->storePartials(*voiceBank, v, voiceBankStride, voiceBankActivePartials[(size_t) v]);
+            voice->endIfSilent();
         }
-        fclose(fp);
+
+        output += left;
+        numSamples -= left;
     }
 }
+#endif
 
-Synth::Voice::Voice(juce::AudioProcessorValueTreeState& state)
+//==============================================================================
+
+Synth::Voice::Voice(const ParameterSnapshot& parametersToUse, const WavetableBank& wavetablesToUse,
+    const GlobalLfo& globalLfoToUse, const TuningStore& tuningToUse)
+    : parameters(parametersToUse), wavetables(wavetablesToUse), globalLfo(globalLfoToUse), tuning(tuningToUse)
 {
 
     for (int i = 0; i < Synth::numOscillators; ++i)
     {
         oscillators.push_back(std::make_unique<BaseOscillator>());
         auto& osc = oscillators.back();
-        osc->gain = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("osc" + juce::String(i)));  
-        osc->detune = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("detune" + juce::String(i)));
-        osc->wave_form = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter("wave_form" + juce::String(i)));
-        osc->gainA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("oscA" + juce::String(i)));
-        osc->detuneA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("detuneA" + juce::String(i)));
-        osc->wave_formA = dynamic_cast<juce::AudioParameterChoice*>(state.getParameter("wave_formA" + juce::String(i)));
-        osc->attackA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("attackA" + juce::String(i)));
-        osc->decayA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("decayA" + juce::String(i)));
-        osc->sustainA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("sustainA" + juce::String(i)));
-        osc->releaseA = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter("releaseA" + juce::String(i)));
+        osc->parameters = &parameters.oscillators[i];
+        osc->slot = i;
         osc->osc.get<0>().initialise([](auto arg) {return std::sin(arg); }, 512);
         osc->multiplier = 1.0;//i + 1;
     }
 
-    gainParameter = dynamic_cast<juce::AudioParameterFloat*>(state.getParameter(IDs::paramGain));
-    jassert(gainParameter);
-
-    oscillatorBuffer.setSize(1, internalBufferSize);
     voiceBuffer.setSize(1, internalBufferSize);
-
-   ;
-    
-    loadcustomwave("cu1.txt", 0);
-    loadcustomwave("cu2.txt", 1);
-    loadcustomwave("cu3.txt", 2);
-    loadcustomwave("cu4.txt", 3);
-    loadcustomwave("cu5.txt", 4);
-    loadcustomwave("cu6.txt", 5);
-    loadcustomwave("cu7.txt", 6);
+    envelopeBuffer.setSize(1, internalBufferSize);
+    voiceEnvelopeBuffer.setSize(1, internalBufferSize);
+    modulationBuffer.setSize(1, internalBufferSize);
+#if JUCE_USE_SIMD
+    partialBank = std::make_unique<PartialBank>(Synth::numOscillators, internalBufferSize);
+#endif
 }
 
 bool Synth::Voice::canPlaySound(juce::SynthesiserSound* sound)
@@ -182,23 +1327,33 @@ void Synth::Voice::startNote(int midiNoteNumber,
 {
     juce::ignoreUnused(midiNoteNumber, velocity);
 
-    if (auto* foleysSound = dynamic_cast<Sound*>(sound))
-        adsr.setParameters(foleysSound->getADSR());
+    juce::ignoreUnused(sound);
+    adsr.setParameters(parameters.adsr);
 
-    pitchWheelValue = getDetuneFromPitchWheel(currentPitchWheelPosition);
+    // a note starts at its bend and timbre rather than gliding from the last note's
+    pitchWheelPosition = currentPitchWheelPosition;
+    updatePitchBendTarget();
+    pitchBend.setCurrentAndTargetValue(pitchBend.getTargetValue());
+    tuningGlide = 0.0;
+    tuningGlideSamples = 0;
+    adaptiveOffset.setCurrentAndTargetValue(0.0);
+    adaptiveSnap = true;
+    pitchBendRatio = std::exp2(pitchBend.getCurrentValue() / 12.0);
+    timbre.setCurrentAndTargetValue(timbre.getTargetValue());
+    updateTimbre();
 
     adsr.noteOn();
 
     for (auto& osc : oscillators) {
         updateFrequency(*osc, true);
-        osc->currentAngle = 0.0;
-        osc->currentAngleA = 0.0;
-        osc->angleDeltaA = osc->detuneA->get() * juce::MathConstants<double>::twoPi / getSampleRate();
-        osc->releaseGain = 0.0;
-        osc->lastGainASDR = 0.0;
-    }
-    starttime = timeG;
-    released = false;
+        osc->phase = 0;
+        osc->phaseA = 0;
+        osc->phaseDeltaA = PhaseAccumulator::getIncrement(osc->parameters->lfoFrequency, getSampleRate());
+        osc->envelope.reset();
+        osc->envelope.setParameters(osc->parameters->envelope);
+        osc->envelope.noteOn();
+    }
+    lastVoiceLevel = 0.0;
     //loadInstruments();
 }
 
@@ -217,179 +1372,286 @@ void Synth::Voice::stopNote(float velocity,
         clearCurrentNote();
     }
     for (auto& osc : oscillators) {
-        osc->releaseGain = osc->lastGainASDR;
+        osc->envelope.noteOff();
     }
-    starttimeR = timeG;
-    released = true;
 }
 
 void Synth::Voice::pitchWheelMoved(int newPitchWheelValue)
 {
-    pitchWheelValue = getDetuneFromPitchWheel(newPitchWheelValue);
+    pitchWheelPosition = newPitchWheelValue;
+    updatePitchBendTarget();
 }
 
-void Synth::Voice::controllerMoved(int controllerNumber, int newControllerValue)
+void Synth::Voice::setPitchBendRange(int semitones)
 {
-    juce::ignoreUnused(controllerNumber, newControllerValue);
+    pitchBendRange = semitones;
+    updatePitchBendTarget();
 }
 
-float Synth::Voice::getOscASDR(BaseOscillator& osc) { //timeG juce::Time::currentTimeMillis()
-    float time_e = (timeG - starttime) / getSampleRate();
-    if (released) {
-        float time_e = (timeG - starttimeR) / getSampleRate();
-        if (time_e < osc.releaseA->get()) {
-            osc.lastGainASDR = time_e * (0.0 - osc.releaseGain) / (osc.releaseA->get()) + osc.releaseGain;
-        }
-        else {
-            osc.lastGainASDR = 0.0;
-        }
-    }else if (time_e < osc.attackA->get()) {
-        osc.lastGainASDR = time_e / (osc.attackA->get());
-    }else if (time_e < (osc.decayA->get() + osc.attackA->get())) {
-        osc.lastGainASDR = ((float) time_e - (osc.attackA->get())) * (osc.sustainA->get() - 1.0) / (osc.decayA->get()) + 1.0;
-    }
-    else {
-        osc.lastGainASDR = osc.sustainA->get();
+void Synth::Voice::setMasterBend(double semitones)
+{
+    masterBend = semitones;
+    updatePitchBendTarget();
+}
+
+void Synth::Voice::setNoteBend(double semitones)
+{
+    noteBend = semitones;
+    updatePitchBendTarget();
+}
+
+void Synth::Voice::updatePitchBendTarget()
+{
+    pitchBend.setTargetValue(getBendFromPitchWheel(pitchWheelPosition, pitchBendRange) + masterBend + noteBend);
+}
+
+void Synth::Voice::setAdaptiveOffset(double semitones)
+{
+    if (!adaptiveSnap)
+    {
+        adaptiveOffset.setTargetValue(semitones);
+        return;
     }
-    return osc.lastGainASDR;
+
+    // a new note is struck in tune with the chord rather than sliding into it
+    adaptiveSnap = false;
+    adaptiveOffset.setCurrentAndTargetValue(semitones);
+    updatePitchBend();
+}
+
+void Synth::Voice::setNoteFrequency(double frequency)
+{
+    noteFrequency = frequency;
+    if (isVoiceActive())
+        retune();
+}
+
+void Synth::Voice::aftertouchChanged(int newAftertouchValue)
+{
+    setPressure(newAftertouchValue / 127.0f);
+}
+
+void Synth::Voice::channelPressureChanged(int newChannelPressureValue)
+{
+    setPressure(newChannelPressureValue / 127.0f);
 }
 
-float Synth::Voice::getOsc(float currentAngleR, int wave_form) {
-    if (wave_form == 0) {
-            return std::sin(currentAngleR);
+void Synth::Voice::retune(double glideSeconds)
+{
+    // glide from what is heard now, which may be partway through an earlier glide
+    const auto heard = tunedFrequency * std::exp2(tuningGlide / 12.0);
+    const auto target = noteFrequency > 0.0 ? noteFrequency : tuning.getActive().getKey(getCurrentlyPlayingNote()).frequency;
+
+    // the glide is linear in semitones, so every whole internal block moves the pitch by the same ratio
+    if (glideSeconds > 0.0 && heard > 0.0 && target > 0.0)
+    {
+        tuningGlide = 12.0 * std::log2(heard / target);
+        tuningGlideSamples = juce::jmax(1, juce::roundToInt(glideSeconds * getSampleRate()));
+        tuningGlideStep = -tuningGlide / tuningGlideSamples;
+        tuningGlideBlockRatio = std::exp2(tuningGlideStep * internalBlockSize / 12.0);
     }
-    else if (wave_form == 1) {
-        float sampleSound = 0.0;
-        sampleSound = currentAngleR /
-            juce::MathConstants<float>::pi - 1;
-        if (sampleSound > (float)0.0) {
-            sampleSound = (float)1.0;
-        }
-        else {
-            sampleSound = (float)-1.0;
-        }
-        return sampleSound;
-    }
-    else if (wave_form == 2) {
-        float sampleSound = 0.0;
-        sampleSound = currentAngleR /
-            juce::MathConstants<float>::pi - 1;
-        return sampleSound;
-    }
-    else  if (wave_form == 3) {
-        float sampleSound = 0.0;
-        sampleSound = 2 * currentAngleR /
-            juce::MathConstants<float>::pi - 2;
-        if (sampleSound > 0) {
-            sampleSound = sampleSound * -1.0;
-        }
-        return (sampleSound + 1);
-    }
-    else if (wave_form >= 4 && wave_form < 4 + 7) {
-        int cu_ind = wave_form - 4;
-        if (cu_t[cu_ind] >= 1.0) {
-            float sampleSound = 0.0;
-            float x = (currentAngleR * cu_t[wave_form - 4]) / juce::MathConstants<float>::twoPi;
-            int index = floor(x);
-            sampleSound = (float)(cu_w[cu_ind].at(index + 1) - cu_w[cu_ind].at(index)) * (x - (float)index) + cu_w[cu_ind].at(index);
-            return sampleSound;
-        }
+    else
+    {
+        tuningGlide = 0.0;
+        tuningGlideSamples = 0;
     }
-    return 0.0;
+
+    updatePitchBend();
+}
+
+void Synth::Voice::controllerMoved(int controllerNumber, int newControllerValue)
+{
+    // CC 74 is MPE's timbre dimension
+    if (controllerNumber == 74)
+        setTimbre(juce::jlimit(-1.0f, 1.0f, (newControllerValue - 64) / 63.0f));
+}
+
+void Synth::Voice::updateOscEnvelopes()
+{
+    for (auto& osc : oscillators)
+        osc->envelope.setParameters(osc->parameters->envelope);
+}
+
+void Synth::Voice::setEnvelopeCurve(EnvelopeGenerator::Curve newCurve)
+{
+    for (auto& osc : oscillators)
+        osc->envelope.setCurve(newCurve);
 }
 
-void incCurrentAngle(float & currentAngleR, float angleDeltaR) {
-    currentAngleR += angleDeltaR;
-    if (currentAngleR >= juce::MathConstants<float>::twoPi) { currentAngleR = fmod(currentAngleR, juce::MathConstants<float>::twoPi); }
+bool Synth::Voice::prepareOscillator(BaseOscillator& osc, OscillatorKernels::State& state) const
+{
+    state.gain = osc.parameters->gain * osc.timbreGain;
+    if (state.gain < 0.01)
+        return false;
+
+    // nothing this partial can reach through both envelopes and its LFO would be heard;
+    // rising envelopes are left alone so no attack is cut
+    const auto peak = state.gain * osc.envelope.getLevel() * adsr.getLevel() * (1.0f + std::abs(osc.parameters->gainA));
+    if (peak < partialFloor && !osc.envelope.isAttacking() && !adsr.isAttacking())
+        return false;
+
+    // the mip level follows the increment, so each block reads a table with no harmonics past Nyquist
+    state.carrierTable = wavetables.getTable(osc.parameters->waveForm, osc.phaseDelta);
+    if (state.carrierTable == nullptr)
+        return false;
+
+    state.lfoDepth = osc.parameters->gainA;
+    if (state.lfoDepth == 0.0f)
+        state.lfoTable = nullptr;
+    else if (osc.parameters->lfoGlobal)
+        state.modulation = globalLfo.getModulation(osc.slot);
+    else
+        state.lfoTable = wavetables.getTable(osc.parameters->waveFormA, osc.phaseDeltaA);
+
+    state.phase = osc.phase;
+    state.phaseDelta = osc.phaseDelta;
+    state.phaseA = osc.phaseA;
+    state.phaseDeltaA = osc.phaseDeltaA;
+    return true;
 }
 
-void Synth::Voice::getSamples(BaseOscillator& osc, juce::dsp::ProcessContextReplacing<float>& pc) {
-    juce::dsp::AudioBlock<float> buffer = pc.getOutputBlock();
-    int totalSamples = buffer.getNumSamples();
-    int sampleNum = 0;
-    auto oscGain = osc.gain->get();
-    auto wave_form = osc.wave_form->getIndex();
-    if (oscGain < 0.01)
+void Synth::Voice::getSamples(BaseOscillator& osc, float* output, int numSamples) {
+    OscillatorKernels::State state;
+    if (!prepareOscillator(osc, state)) {
+        osc.envelope.skip(numSamples);
         return;
-    if (wave_form == 0) {
-        float sampleSound = 0.0;
-        while (sampleNum < totalSamples) {
-            sampleSound = std::sin(osc.currentAngle);
-            sampleSound *= oscGain * ((float) getOsc(osc.currentAngleA, osc.wave_formA->getIndex()) * osc.gainA->get() + 1.0) * getOscASDR(osc);
-            buffer.addSample(0, sampleNum, sampleSound);
-            incCurrentAngle(osc.currentAngle,osc.angleDelta);
-            incCurrentAngle(osc.currentAngleA, osc.angleDeltaA);
-            sampleNum++;
-            timeG++;
-        }
     }
-    else if (wave_form == 1) {
-        float sampleSound = 0.0;
-        while (sampleNum < totalSamples) {
-            sampleSound = osc.currentAngle /
-                juce::MathConstants<float>::pi - 1;
-            if (sampleSound > (float)0.0) {
-                sampleSound = (float)1.0;
-            }
-            else {
-                sampleSound = (float)-1.0;
-            }
-            sampleSound *= oscGain * ((float) getOsc(osc.currentAngleA, osc.wave_formA->getIndex()) * osc.gainA->get() + 1.0) * getOscASDR(osc);
-            buffer.addSample(0, sampleNum, sampleSound);
-            incCurrentAngle(osc.currentAngle, osc.angleDelta);
-            incCurrentAngle(osc.currentAngleA, osc.angleDeltaA);
-            sampleNum++;
-            timeG++;
-        }
+
+    jassert(numSamples <= envelopeBuffer.getNumSamples());
+
+    auto* envelope = envelopeBuffer.getWritePointer(0);
+    osc.envelope.render(envelope, numSamples);
+
+    state.output = output;
+    state.envelope = envelope;
+    state.numSamples = numSamples;
+
+    if (state.lfoTable != nullptr)
+    {
+        auto* modulation = modulationBuffer.getWritePointer(0);
+        OscillatorKernels::renderModulation(state, modulation, lfoControlInterval);
+        juce::FloatVectorOperations::multiply(envelope, modulation, numSamples);
     }
-    else if (wave_form == 2) {
-        float sampleSound = 0.0;
-        while (sampleNum < totalSamples) {
-            sampleSound = osc.currentAngle /
-                juce::MathConstants<float>::pi - 1;
-            sampleSound *= oscGain * ((float) getOsc(osc.currentAngleA, osc.wave_formA->getIndex()) * osc.gainA->get() + 1.0) * getOscASDR(osc);
-            buffer.addSample(0, sampleNum, sampleSound);
-            incCurrentAngle(osc.currentAngle, osc.angleDelta);
-            incCurrentAngle(osc.currentAngleA, osc.angleDeltaA);
-            sampleNum++;
-            timeG++;
-        }
+    else
+    {
+        state.phaseA += state.phaseDeltaA * juce::uint32(numSamples);
+        if (state.modulation != nullptr)
+            juce::FloatVectorOperations::multiply(envelope, state.modulation, numSamples);
     }
-    else  if (wave_form == 3) {
-        float sampleSound = 0.0;
-        while (sampleNum < totalSamples) {
-            sampleSound = 2 * osc.currentAngle /
-                juce::MathConstants<float>::pi - 2;
-            if (sampleSound > 0) {
-                sampleSound = sampleSound * -1.0;
-            }
-            sampleSound += 1;
-            sampleSound *= oscGain * ((float) getOsc(osc.currentAngleA, osc.wave_formA->getIndex()) * osc.gainA->get() + 1.0) * getOscASDR(osc);
-            buffer.addSample(0, sampleNum, sampleSound);
-            incCurrentAngle(osc.currentAngle, osc.angleDelta);
-            incCurrentAngle(osc.currentAngleA, osc.angleDeltaA);
-            sampleNum++;
-            timeG++;
-        }
-    }else if (wave_form >= 4 && wave_form < 4 + 7) {
-        int cu_ind = wave_form - 4;
-        if (cu_t[cu_ind] >= 1.0) {
-            float sampleSound = 0.0;
-            while (sampleNum < totalSamples) {
-                float x = (osc.currentAngle * cu_t[wave_form - 4]) / juce::MathConstants<float>::twoPi;
-                int index = floor(x);
-                sampleSound = (float)(cu_w[cu_ind].at(index + 1) - cu_w[cu_ind].at(index)) * (x - (float)index) + cu_w[cu_ind].at(index);
-                sampleSound *= oscGain * ((float) getOsc(osc.currentAngleA, osc.wave_formA->getIndex()) * osc.gainA->get() + 1.0) * getOscASDR(osc);
-                buffer.addSample(0, sampleNum, sampleSound);
-                incCurrentAngle(osc.currentAngle, osc.angleDelta);
-                incCurrentAngle(osc.currentAngleA, osc.angleDeltaA);
-                sampleNum++;
-                timeG++;
-            }
+
+    OscillatorKernels::getKernel(interpolation)(state);
+
+    osc.phase = state.phase;
+    osc.phaseA = state.phaseA;
+}
+
+void Synth::Voice::renderPartials(float* output, int numSamples)
+{
+#if JUCE_USE_SIMD
+    auto activePartials = loadPartials(*partialBank, 0, 1, numSamples, nullptr);
+    if (activePartials == 0)
+        return;
+
+    partialBank->render(output, numSamples, interpolation, lfoControlInterval);
+    storePartials(*partialBank, 0, 1, activePartials);
+#else
+    for (auto& osc : oscillators)
+        getSamples(*osc, output, numSamples);
+#endif
+}
+
+#if JUCE_USE_SIMD
+juce::uint32 Synth::Voice::loadPartials(PartialBank& bank, int firstSlot, int slotStride, int numSamples,
+    const float* amplitude)
+{
+    jassert(numSamples <= envelopeBuffer.getNumSamples());
+
+    juce::uint32 activePartials = 0;
+    auto* levels = envelopeBuffer.getWritePointer(0);
+
+    for (size_t i = 0; i < oscillators.size(); ++i)
+    {
+        auto& osc = *oscillators[i];
+        auto slot = firstSlot + (int) i * slotStride;
+        OscillatorKernels::State state;
+        PartialBank::Partial partial;
+
+        if (!prepareOscillator(osc, state))
+        {
+            osc.envelope.skip(numSamples);
+            bank.clearPartial(slot);
+            continue;
         }
+
+        partial.carrierTable = state.carrierTable;
+        partial.lfoTable = state.lfoTable;
+        partial.modulation = state.modulation;
+        partial.phase = state.phase;
+        partial.phaseDelta = state.phaseDelta;
+        partial.phaseA = state.phaseA;
+        partial.phaseDeltaA = state.phaseDeltaA;
+        partial.gain = state.gain;
+        partial.lfoDepth = state.lfoDepth;
+
+        // the bank copies the levels in, so one buffer serves every oscillator
+        osc.envelope.render(levels, numSamples);
+        if (amplitude != nullptr)
+            juce::FloatVectorOperations::multiply(levels, amplitude, numSamples);
+        partial.envelope = levels;
+
+        bank.setPartial(slot, partial, numSamples);
+        activePartials |= 1u << i;
+    }
+
+    return activePartials;
+}
+
+void Synth::Voice::storePartials(const PartialBank& bank, int firstSlot, int slotStride, juce::uint32 activePartials)
+{
+    for (size_t i = 0; i < oscillators.size(); ++i)
+    {
+        if ((activePartials & (1u << i)) == 0)
+            continue;
+
+        auto& osc = *oscillators[i];
+        auto slot = firstSlot + (int) i * slotStride;
+        osc.phase = bank.getPhase(slot);
+        osc.phaseA = bank.getPhaseA(slot);
+    }
+}
+
+void Synth::Voice::clearPartials(PartialBank& bank, int firstSlot, int slotStride)
+{
+    for (size_t i = 0; i < oscillators.size(); ++i)
+        bank.clearPartial(firstSlot + (int) i * slotStride);
+}
+
+juce::uint32 Synth::Voice::loadVoiceBankPartials(PartialBank& bank, int firstSlot, int slotStride, int numSamples)
+{
+    // the voice ADSR and output gain are multiplied into each partial's envelope, sample by sample
+    updateExpression(numSamples);
+    updateOscEnvelopes();
+
+    auto* amplitude = voiceEnvelopeBuffer.getWritePointer(0);
+    adsr.render(amplitude, numSamples);
+
+    // the gain ramps across the block as addFromWithRamp does on the per-voice path
+    const auto gain = parameters.gain * (1.0f + pressure);
+    const auto gainStep = (gain - lastGain) / float(numSamples);
+    auto rampGain = lastGain;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        amplitude[i] *= rampGain;
+        rampGain += gainStep;
     }
-   
+
+    auto activePartials = loadPartials(bank, firstSlot, slotStride, numSamples, amplitude);
+
+    lastVoiceLevel = adsr.getLevel();
+    lastGain = gain;
+    return activePartials;
 }
+#endif
 
 void Synth::Voice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
     int startSample,
@@ -400,41 +1662,73 @@ void Synth::Voice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
 
     while (numSamples > 0)
     {
-        auto left = std::min(numSamples, oscillatorBuffer.getNumSamples());
-        auto block = juce::dsp::AudioBlock<float>(oscillatorBuffer).getSingleChannelBlock(0).getSubBlock(0, size_t(left));
+        auto left = std::min(numSamples, voiceBuffer.getNumSamples());
 
-        juce::dsp::ProcessContextReplacing<float> context(block);
         voiceBuffer.clear();
-        for (auto& osc : oscillators)
-        {
-            oscillatorBuffer.clear();
-            getSamples(*osc, context);
-            voiceBuffer.addFrom(0, 0, context.getInputBlock().getChannelPointer(0), left);
-            /*updateFrequency(*osc);
-            osc->osc.get<1>().setGainLinear(oscGain);
-            oscillatorBuffer.clear();
-            osc->osc.process(context);
-            voiceBuffer.addFrom(0, 0, oscillatorBuffer.getReadPointer(0), left);*/
-        }
+        updateExpression(left);
+        updateOscEnvelopes();
+        renderPartials(voiceBuffer.getWritePointer(0), left);
 
-        adsr.applyEnvelopeToBuffer(voiceBuffer, 0, left);
+        auto* levels = voiceEnvelopeBuffer.getWritePointer(0);
+        adsr.render(levels, left);
+        juce::FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0), levels, left);
+        lastVoiceLevel = adsr.getLevel();
 
-        const auto gain = gainParameter->get();
+        // pressure rides the same per-block gain ramp, up to +6 dB
+        const auto gain = parameters.gain * (1.0f + pressure);
         outputBuffer.addFromWithRamp(0, startSample, voiceBuffer.getReadPointer(0), left, lastGain, gain);
         lastGain = gain;
 
         startSample += left;
         numSamples -= left;
 
-        if (!adsr.isActive())
-            clearCurrentNote();
+        endIfSilent();
+        if (!isVoiceActive())
+            return;
+    }
+}
+
+void Synth::Voice::endIfSilent()
+{
+    if (!isVoiceActive())
+        return;
+
+    if (adsr.isActive())
+    {
+        if (adsr.isAttacking())
+            return;
+
+        // the loudest level any partial could still reach through its envelope and LFO
+        auto peak = 0.0f;
+        for (auto& osc : oscillators)
+        {
+            if (osc->envelope.isAttacking())
+                return;
+            peak = juce::jmax(peak, osc->envelope.getLevel() * (1.0f + std::abs(osc->parameters->gainA)));
+        }
+
+        if (peak * adsr.getLevel() >= silenceLevel)
+            return;
     }
+
+    adsr.reset();
+    for (auto& osc : oscillators)
+        osc->envelope.reset();
+    clearCurrentNote();
 }
 
 void Synth::Voice::setCurrentPlaybackSampleRate(double newRate)
 {
     juce::SynthesiserVoice::setCurrentPlaybackSampleRate(newRate);
 
+    adsr.setSampleRate(newRate);
+    for (auto& osc : oscillators)
+        osc->envelope.setSampleRate(newRate);
+
+    pitchBend.reset(newRate, expressionSmoothingSeconds);
+    adaptiveOffset.reset(newRate, adaptiveTuningGlideSeconds);
+    timbre.reset(newRate, expressionSmoothingSeconds);
+
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = newRate;
     spec.maximumBlockSize = juce::uint32(internalBufferSize);
@@ -443,31 +1737,72 @@ void Synth::Voice::setCurrentPlaybackSampleRate(double newRate)
         osc->osc.prepare(spec);
 }
 
-double Synth::Voice::getFrequencyForNote(int noteNumber, double detune, double concertPitch) const
+double Synth::Voice::getBendFromPitchWheel(int wheelValue, int rangeSemitones)
+{
+    return (wheelValue - 8192) / (wheelValue > 8192 ? 8191.0 : 8192.0) * rangeSemitones;
+}
+
+void Synth::Voice::updateExpression(int numSamples)
 {
-    return concertPitch * std::pow(2.0, (noteNumber + detune - 69.0) / 12.0);
+    const auto tuningGliding = tuningGlideSamples > 0;
+    if (tuningGliding)
+    {
+        const auto step = juce::jmin(numSamples, tuningGlideSamples);
+        tuningGlideSamples -= step;
+        tuningGlide = tuningGlideSamples > 0 ? tuningGlide + tuningGlideStep * step : 0.0;
+    }
+
+    // recomputed per block, and only while gliding, so a held note costs nothing here. A tuning
+    // glide on its own steps by its precomputed ratio; the last block snaps to the exact pitch
+    if (pitchBend.isSmoothing() || adaptiveOffset.isSmoothing()
+        || (tuningGliding && (tuningGlideSamples == 0 || numSamples != internalBlockSize)))
+    {
+        pitchBend.skip(numSamples);
+        adaptiveOffset.skip(numSamples);
+        updatePitchBend();
+    }
+    else if (tuningGliding)
+    {
+        pitchBendRatio *= tuningGlideBlockRatio;
+        for (auto& osc : oscillators)
+            updateFrequency(*osc);
+    }
+
+    if (timbre.isSmoothing())
+    {
+        timbre.skip(numSamples);
+        updateTimbre();
+    }
+}
+
+void Synth::Voice::updatePitchBend()
+{
+    pitchBendRatio = std::exp2((pitchBend.getCurrentValue() + tuningGlide + adaptiveOffset.getCurrentValue()) / 12.0);
+    for (auto& osc : oscillators)
+        updateFrequency(*osc);
 }
 
-double Synth::Voice::getDetuneFromPitchWheel(int wheelValue) const
+void Synth::Voice::updateTimbre()
 {
-    return (wheelValue / 8192.0) - 1.0;
+    // tilts the partials about the middle one, by up to 6 dB at either end
+    const auto last = juce::jmax(1, (int) oscillators.size() - 1);
+    for (size_t i = 0; i < oscillators.size(); ++i)
+        oscillators[i]->timbreGain = std::exp2(timbre.getCurrentValue() * (2.0f * (float) i / (float) last - 1.0f));
 }
 
 void Synth::Voice::updateFrequency(BaseOscillator& oscillator, bool noteStart)
 {
-    int singleOctaveIndex = (((int)getCurrentlyPlayingNote() - 72) % 12 + 12) % 12, 
-        totalSynthIndex = ((int)getCurrentlyPlayingNote() - 72);
+    const auto& key = tuning.getActive().getKey(getCurrentlyPlayingNote());
+    const auto ratio = oscillator.parameters->detune * pitchBendRatio;
 
-    double newFrequency = microtonalMappings[mappingGroup].frequencies[singleOctaveIndex].frequency, 
-        defaultFrequency = 440.0 * std::pow(2.0, (float)((int)getCurrentlyPlayingNote() - 81) / 12.0);
+    tunedFrequency = noteFrequency > 0.0 ? noteFrequency : key.frequency;
 
-    newFrequency = (newFrequency == NULL)
-        ? defaultFrequency // note unmapped
-        : (totalSynthIndex < 0)
-            ? newFrequency * std::pow(2.0, -1.0 * (float)((totalSynthIndex * -1 + 11) / 12)) // note lower than C4
-            : newFrequency * std::pow(2.0, (totalSynthIndex / 12)); // note higher than B5
+    // a MIDI 2.0 pitch bypasses the tuning table
+    if (noteFrequency > 0.0)
+        oscillator.phaseDelta = PhaseAccumulator::getIncrement(noteFrequency / getSampleRate() * ratio);
+    else
+        oscillator.phaseDelta = ratio == 1.0 ? key.phaseDelta : PhaseAccumulator::getIncrement(key.cyclesPerSample * ratio);
 
-    oscillator.angleDelta = (newFrequency * oscillator.detune->get() / getSampleRate()) * juce::MathConstants<double>::twoPi;
-    if (noteStart) oscillator.currentAngle = 0.0;
-    oscillator.osc.get<0>().setFrequency(float(newFrequency * oscillator.detune->get()), noteStart);
+    if (noteStart) oscillator.phase = 0;
+    oscillator.osc.get<0>().setFrequency(float((noteFrequency > 0.0 ? noteFrequency : key.frequency) * ratio), noteStart);
 }
\ No newline at end of file
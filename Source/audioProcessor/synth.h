@@ -12,46 +12,185 @@
 
 
 #include "JuceHeader.h"
+#include "adaptiveTuning.h"
+#include "engineContext.h"
+#include "envelopeGenerator.h"
+#include "globalLfo.h"
+#include "oscillatorKernels.h"
+#include "parameterSnapshot.h"
+#include "qualityGovernor.h"
+#include "tuningStore.h"
+#include "universalMidi.h"
+#include "partialBank.h"
+#include "voiceAllocator.h"
+#include "voiceRenderPool.h"
+#include "wavetableBank.h"
+#include <array>
 #include <stdio.h>
 #include <stdlib.h>
 #include <vector>
 #include <math.h>
 
-class Synth : public juce::Synthesiser
+class Synth : public juce::Synthesiser,
+              private juce::Timer
 {
 public:
     static int  numOscillators;
+    static constexpr int internalBlockSize = 64;
+    static constexpr int defaultPolyphony = 64;
+    static constexpr float defaultSilenceThresholdDb = -90.0f;
+    static constexpr double parameterSmoothingSeconds = 0.02;
+    static constexpr double expressionSmoothingSeconds = 0.01;
+    static constexpr int defaultPitchBendRange = 2;
+    static constexpr int mpeNotePitchBendRange = 48;
+    static constexpr double adaptiveTuningGlideSeconds = 0.05;
 
     static void addADSRParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
     static void addOvertoneParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
     static void addGainParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
-
-    Synth() = default;
+    /* LFO mode and tempo sync for each oscillator's second partial; a group of their own,
+       added after the instruments, so existing parameters keep their indices */
+    static void addOscillatorLfoParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
+    /* How the engine renders rather than what it plays; add these after every other group,
+       so existing parameters keep their indices in saved sessions */
+    static void addEngineParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
+    /* Tuning changes and retuning; add these after the engine group */
+    static void addTuningParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
+
+    /* Reads its mappings from context, which must outlive it */
+    explicit Synth(const EngineContext& context);
+    ~Synth() override;
+
+    const WavetableBank& getWavetables() const { return *wavetables; }
+
+    /* Finds the parameters made by the add*Parameters functions in state */
+    void attachParameters(juce::AudioProcessorValueTreeState& state);
+    /* Copies every parameter into the snapshot; call once per block before rendering */
+    void updateParameters(int numSamples);
+    const ParameterSnapshot& getParameterSnapshot() const { return parameterSnapshot; }
+    const GlobalLfo& getGlobalLfo() const { return globalLfo; }
+    const TuningStore& getTuning() const { return tuning; }
+
+    /* Picks up the latest published tuning for this block; call once per block before rendering */
+    void updateTuning();
+    /* Compiles the selected mapping and publishes it to the audio thread if it changed since the
+       last publish, and rebuilds the tuning bank if any of its sources changed; runs on a message
+       thread timer, but can be called from any non-audio thread */
+    void publishTuning();
+
+    /* The bank a MIDI program change selects from holds the seven mappings, then every tuning
+       library has found. Bank Select (CC 0 and 32) picks the 128 entries a program number counts
+       from. A selection lasts until the GUI picks a mapping or the sample rate changes */
+    void setTuningLibrary(std::shared_ptr<TuningLibrary> library);
+    /* How long sounding notes take to glide to a newly selected tuning; 0 moves them at once.
+       Follows the "tuningGlide" parameter */
+    void setTuningGlide(double seconds) { tuningGlideSeconds = juce::jmax(0.0, seconds); }
+
+    /* Adaptive just intonation: whenever the held notes change, the chord they make is
+       analysed and each note is bent towards a pure ratio from its root, within the drift
+       limit of its key's pitch. A newly struck note starts at its offset; held ones glide.
+       Follows the "adaptiveTuning", "adaptiveDrift", "adaptiveTolerance" and "adaptiveAnchor" parameters */
+    void setAdaptiveTuningEnabled(bool shouldBeEnabled);
+    void setAdaptiveTuningSettings(const AdaptiveTuning::Settings& newSettings);
+    bool isAdaptiveTuningEnabled() const { return adaptiveTuningEnabled; }
+
+    /* Renders a block like renderNextBlock, but applies MTS tuning messages in midi itself,
+       at their sample positions and without allocating, before handing the rest to juce::Synthesiser */
+    void render(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& midi, int startSample, int numSamples);
+    /* The same, with MIDI 2.0 packets, sorted by sample position, interleaved with midi. A note-on
+       carrying a pitch attribute plays that exact pitch instead of its key's tuning. JUCE's plugin
+       wrappers only deliver MIDI 1.0, so this is for code that receives packets itself */
+    void render(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& midi,
+                const UniversalMidi::Packet* packets, int numPackets, int startSample, int numSamples);
+
+    /* Reads tempo and song position for synced LFOs; call once per block before updateParameters */
+    void updateTransport(juce::AudioPlayHead* playHead);
+
+    /* Trades wavetable read quality against CPU for every voice; the quality governor can
+       lower it further, never raise it. Follows the "interpolation" parameter */
+    void setInterpolation(WavetableBank::Interpolation newInterpolation);
+
+    /* Shape of the per-oscillator envelopes; the voice envelope stays linear.
+       Follows the "envelopeCurve" parameter */
+    void setEnvelopeCurve(EnvelopeGenerator::Curve newCurve);
+
+    /* Reads the oscillator LFOs every numSamples and interpolates in between;
+       1 keeps them at audio rate. Follows the "lfoControlInterval" parameter */
+    void setLfoControlInterval(int numSamples);
+
+    /* Renders all voices through one structure-of-arrays PartialBank, with the
+       same partial of neighbouring voices sharing a SIMD register, whenever at
+       least a register's worth of voices is sounding. Off by default; the "voiceBank"
+       parameter switches it once attachParameters has been called */
+    void setVoiceBankEnabled(bool shouldBeEnabled);
+
+    /* Renders sounding voices on numWorkers extra threads plus the audio thread,
+       then sums them in voice order; 0 renders everything on the audio thread.
+       Blocks with few sounding voices still go through the serial path.
+       Starts and stops threads, so call it away from the audio thread. Follows the
+       "renderThreads" parameter, checked on the tuning timer and when the sample rate is set */
+    void setRenderThreads(int numWorkers);
+    /* Number of voices, up to VoiceAllocator::maxVoices; the voices are created
+       by the next setCurrentPlaybackSampleRate, so call this before prepareToPlay.
+       setCurrentPlaybackSampleRate reads it from the "polyphony" parameter */
+    void setPolyphony(int numVoices);
+    int  getPolyphony() const { return polyphony; }
+
+    /* Treats MIDI channel 1 as the master channel of an MPE lower zone and 2-16 as
+       its per-note channels, with MPE's default bend ranges. An MPE configuration
+       message (RPN 6 on channel 1 or 16) switches a zone on or off by itself */
+    void setMpeEnabled(bool shouldBeEnabled);
+    bool isMpeEnabled() const { return mpeMasterChannel != 0; }
+
+    /* Which voice a note-on takes over once every voice is busy; follows the
+       "stealPolicy" parameter from block to block */
+    void setStealPolicy(VoiceAllocator::StealPolicy newPolicy) { stealPolicy = newPolicy; }
+
+    /* Lets the QualityGovernor lower partial, interpolation and voice quality
+       while processBlock runs close to its real-time budget; follows the
+       "adaptiveQuality" parameter, and stays off while rendering offline */
+    void setAdaptiveQualityEnabled(bool shouldBeEnabled);
+    /* Pass AudioProcessor::isNonRealtime() before updateParameters each block */
+    void setNonRealtime(bool isNonRealtime) { nonRealtime = isNonRealtime; }
+    /* Reports how long the whole processBlock took; call once per block at its end */
+    void registerBlockTime(double milliseconds, int numSamples);
+    const QualityGovernor& getQualityGovernor() const { return qualityGovernor; }
+
+    /* A voice ends as soon as everything it could still output stays below this level;
+       follows the "silenceThreshold" parameter */
+    void setSilenceThreshold(float decibels);
+
+    /* True when no voice is sounding, so a block without MIDI would render silence */
+    bool isIdle() const;
+    /* Stands in for renderNextBlock on such a block; keeps the global LFOs running */
+    void skipIdleBlock(int numSamples);
+
+    /* Creates or removes voices to match the polyphony and frees them all */
+    void setCurrentPlaybackSampleRate(double sampleRate) override;
+
+    void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
+    void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
+    void handlePitchWheel(int midiChannel, int wheelValue) override;
+    void handleController(int midiChannel, int controllerNumber, int controllerValue) override;
+    void handleChannelPressure(int midiChannel, int channelPressureValue) override;
+    void handleProgramChange(int midiChannel, int programNumber) override;
 
     class Sound : public juce::SynthesiserSound
     {
     public:
-        Sound(juce::AudioProcessorValueTreeState& state);
+        Sound() = default;
         bool appliesToNote(int) override { return true; }
         bool appliesToChannel(int) override { return true; }
 
-        juce::ADSR::Parameters getADSR();
-
     private:
-        juce::AudioProcessorValueTreeState& state;
-        juce::AudioParameterFloat* attack = nullptr;
-        juce::AudioParameterFloat* decay = nullptr;
-        juce::AudioParameterFloat* sustain = nullptr;
-        juce::AudioParameterFloat* release = nullptr;
-        juce::AudioParameterFloat* gain = nullptr;
-
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Sound)
     };
 
     class Voice : public juce::SynthesiserVoice
     {
     public:
-        Voice(juce::AudioProcessorValueTreeState& state);
+        Voice(const ParameterSnapshot& parameters, const WavetableBank& wavetables, const GlobalLfo& globalLfo,
+            const TuningStore& tuning);
 
         bool canPlaySound(juce::SynthesiserSound*) override;
 
@@ -66,12 +205,42 @@ public:
 
         void controllerMoved(int controllerNumber, int newControllerValue) override;
 
+        void aftertouchChanged(int newAftertouchValue) override;
+
+        void channelPressureChanged(int newChannelPressureValue) override;
+
         void renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
             int startSample,
             int numSamples) override;
 
         void setCurrentPlaybackSampleRate(double newRate) override;
 
+        void setInterpolation(WavetableBank::Interpolation newInterpolation) { interpolation = newInterpolation; }
+        void setEnvelopeCurve(EnvelopeGenerator::Curve newCurve);
+        void setLfoControlInterval(int numSamples) { lfoControlInterval = numSamples; }
+        void setPartialFloor(float newFloor) { partialFloor = newFloor; }
+        void setSilenceLevel(float newLevel) { silenceLevel = newLevel; }
+        /* Rereads the note's frequency after its key has been retuned, gliding from the
+           old one over glideSeconds */
+        void retune(double glideSeconds = 0.0);
+
+        /* Per-note expression, set from the note's channel before it starts and as it
+           changes. Pitch is in semitones on top of the tuning; pressure is 0 to 1 and
+           timbre -1 to 1. Pitch and timbre glide to a new value over a few blocks */
+        void setPitchBendRange(int semitones);
+        void setMasterBend(double semitones);
+        void setPressure(float newPressure) { pressure = newPressure; }
+        void setTimbre(float newTimbre) { timbre.setTargetValue(newTimbre); }
+        /* MIDI 2.0 per-note pitch: a frequency that replaces the key's tuning (0 goes back
+           to the tuning) and a bend in semitones on top of the channel's */
+        void setNoteFrequency(double frequency);
+        void setNoteBend(double semitones);
+        /* Adaptive tuning's offset in semitones; the first after a note starts applies at once */
+        void setAdaptiveOffset(double semitones);
+        /* The note's pitch before any bend or offset, as adaptive tuning hears it */
+        double getTunedFrequency() const { return tunedFrequency; }
+        static double getBendFromPitchWheel(int wheelValue, int rangeSemitones);
+
     private:
 
         class BaseOscillator
@@ -80,62 +249,192 @@ public:
             BaseOscillator() = default;
 
             juce::dsp::ProcessorChain<juce::dsp::Oscillator<float>, juce::dsp::Gain<float>> osc;
-            juce::AudioParameterFloat* gain = nullptr;
-            juce::AudioParameterFloat* detune = nullptr;
-            juce::AudioParameterChoice* wave_form = nullptr;
-            juce::AudioParameterFloat* gainA = nullptr;
-            juce::AudioParameterFloat* detuneA = nullptr;
-            juce::AudioParameterChoice* wave_formA = nullptr;
-            juce::AudioParameterFloat* attackA = nullptr;
-            juce::AudioParameterFloat* decayA = nullptr;
-            juce::AudioParameterFloat* sustainA = nullptr;
-            juce::AudioParameterFloat* releaseA = nullptr;
-            float                       angleDelta = 0.0;
-            float                       angleDeltaA = 0.0; //LFO
-            float                       currentAngle = 0.0;
-            float                       currentAngleA = 0.0;
-            float                       lastGainASDR = 0.0;
-            float                       releaseGain = 0.0;
+            const ParameterSnapshot::Oscillator* parameters = nullptr;
+            int                         slot = 0;
+            juce::uint32                phaseDelta = 0;
+            juce::uint32                phaseDeltaA = 0; //LFO
+            juce::uint32                phase = 0;
+            juce::uint32                phaseA = 0;
+            EnvelopeGenerator           envelope;
             double multiplier = 1.0;
+            float                       timbreGain = 1.0f;
 
         private:
             JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BaseOscillator)
         };
 
-        double getDetuneFromPitchWheel(int wheelValue) const;
-        double getFrequencyForNote(int noteNumber, double detune, double concertPitch = 440.0) const;
-
         void updateFrequency(BaseOscillator& oscillator, bool noteStart = false);
+        void updatePitchBend();
+        void updatePitchBendTarget();
+        void updateTimbre();
+
+        /* Steps pitch and timbre towards their targets; call once per internal block */
+        void updateExpression(int numSamples);
 
         std::vector<std::unique_ptr<BaseOscillator>> oscillators;
 
-        double                      pitchWheelValue = 0.0;
-        int                         maxPitchWheelSemitones = 12;
-        const int                   internalBufferSize = 64;
-        juce::AudioBuffer<float>    oscillatorBuffer;
+        int                         pitchWheelPosition = 8192;
+        int                         pitchBendRange = defaultPitchBendRange;
+        double                      masterBend = 0.0;
+        double                      noteBend = 0.0;
+        double                      noteFrequency = 0.0;  // 0 when the tuning sets the pitch
+        double                      tunedFrequency = 0.0;  // the key's, or noteFrequency, before any bend
+        double                      tuningGlide = 0.0;  // semitones from the new tuning, heading to 0
+        double                      tuningGlideStep = 0.0;  // semitones per sample
+        double                      tuningGlideBlockRatio = 1.0;  // the pitch ratio one internal block of glide moves by
+        int                         tuningGlideSamples = 0;  // left in the glide
+        juce::SmoothedValue<double> pitchBend;  // semitones
+        juce::SmoothedValue<double> adaptiveOffset;  // semitones
+        bool                        adaptiveSnap = false;  // no offset set since the note started
+        double                      pitchBendRatio = 1.0;
+        juce::SmoothedValue<float>  timbre;
+        float                       pressure = 0.0f;
+        const int                   internalBufferSize = internalBlockSize;
         juce::AudioBuffer<float>    voiceBuffer;
-        juce::ADSR                  adsr;
-        juce::AudioParameterFloat* gainParameter = nullptr;
+        juce::AudioBuffer<float>    envelopeBuffer;
+        juce::AudioBuffer<float>    voiceEnvelopeBuffer;
+        juce::AudioBuffer<float>    modulationBuffer;
+#if JUCE_USE_SIMD
+        std::unique_ptr<PartialBank> partialBank;
+#endif
+        const ParameterSnapshot&    parameters;
+        const WavetableBank&        wavetables;
+        const GlobalLfo&            globalLfo;
+        const TuningStore&          tuning;
+        WavetableBank::Interpolation interpolation = WavetableBank::Interpolation::cubic;
+        int                         lfoControlInterval = 1;
+        float                       partialFloor = 0.0f;
+        float                       silenceLevel = 0.0f;
+        EnvelopeGenerator           adsr;
         float                       lastGain = 0.0;
-        int64_t                     timeG = 0;
-        int64_t                     starttime = 0;
-        int64_t                     starttimeR = 0;
-        bool                        released = false;
-        std::vector<float> cu_w[7];
-        float cu_t[7] = { -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0 };
+        float                       lastVoiceLevel = 0.0;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Voice)
 
     public:
-        void getSamples(BaseOscillator& osc, juce::dsp::ProcessContextReplacing<float>& pc);
-        void loadcustomwave(const char* file, int i);
-        float getOscASDR(BaseOscillator& osc);
-        float getOsc(float currentAngleR, int wave_form);
+        bool prepareOscillator(BaseOscillator& osc, OscillatorKernels::State& state) const;
+        void getSamples(BaseOscillator& osc, float* output, int numSamples);
+        void renderPartials(float* output, int numSamples);
+#if JUCE_USE_SIMD
+        /* amplitude, if set, is a block of per-sample gains multiplied into every partial's envelope */
+        juce::uint32 loadPartials(PartialBank& bank, int firstSlot, int slotStride, int numSamples,
+            const float* amplitude);
+        void storePartials(const PartialBank& bank, int firstSlot, int slotStride, juce::uint32 activePartials);
+        void clearPartials(PartialBank& bank, int firstSlot, int slotStride);
+        juce::uint32 loadVoiceBankPartials(PartialBank& bank, int firstSlot, int slotStride, int numSamples);
+#endif
+        bool isSounding() const { return adsr.isActive(); }
+        float getEnvelopeLevel() const { return adsr.getLevel(); }
+        bool isReleasing() const { return adsr.isReleasing(); }
+        /* Frees the voice once its tail has died away */
+        void endIfSilent();
+        void updateOscEnvelopes();
     };
 
+protected:
+    using juce::Synthesiser::renderVoices;
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+
 private:
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Synth)
-};
+    struct ParameterPointers;
+
+    // below these the thread handoff costs more than rendering serially
+    static constexpr int parallelMinimumVoices = 4;
+    static constexpr int parallelMinimumSamples = 16;
+
+    Voice* createVoice();
+    bool isAllocatorInSync() const { return allocator.getNumVoices() == getNumVoices(); }
+    int  findVoiceToStart(int midiChannel, int midiNoteNumber);
+    void reclaimVoices();
+    void compileTuning(int group);
+    static std::unique_ptr<TuningTable> compileGroup(const MicrotonalConfig& mapping, const CompiledTuning* import, double sampleRate);
+    void compileBank();
+    bool isBankStale() const;
+    void retuneVoices();
+    void updateAdaptiveTuning();
+    void applyTuningMessage(const juce::uint8* data, int size);
+    void setPitchBendRange(int midiChannel, int semitones);
+    void configureMpeZone(int masterChannel, int numMemberChannels);
+    void applyUniversalPacket(const UniversalMidi::Packet& packet);
+    Voice* findPlayingVoice(int midiChannel, int midiNoteNumber);
+    void timerCallback() override;
+    void applyQualityTier();
+    void applyRenderThreads();
+    void limitVoices();
+
+    void renderVoiceBlock(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples);
+    void renderVoicesInParallel(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples);
+    static void renderVoiceJob(void* context, int index);
+#if JUCE_USE_SIMD
+    void renderVoiceBank(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples);
+
+    std::unique_ptr<PartialBank> voiceBank;
+    std::vector<juce::uint32>    voiceBankActivePartials;
+    int                          voiceBankStride = 0;
+#endif
+    bool                         voiceBankEnabled = false;
+    VoiceAllocator                        allocator;
+    VoiceAllocator::StealPolicy           stealPolicy = VoiceAllocator::StealPolicy::oldest;
+    int                                   polyphony = defaultPolyphony;
+    int                                   voiceLimit = defaultPolyphony;
+    QualityGovernor                       qualityGovernor;
+    bool                                  adaptiveQualityEnabled = false;
+    bool                                  nonRealtime = false;
+    float                                 silenceThresholdDb = defaultSilenceThresholdDb;
+    float                                 silenceLevel = juce::Decibels::decibelsToGain(defaultSilenceThresholdDb);
+    std::unique_ptr<VoiceRenderPool>      renderPool;
+    int                                   numRenderThreads = 0;  // message thread; workers in renderPool
+    std::vector<juce::AudioBuffer<float>> voiceScratch;
+    std::vector<int>                      parallelVoices;
+    int                                   parallelNumSamples = 0;
+    std::shared_ptr<const WavetableBank> wavetables;
+    const EngineContext&                 context;
+    std::unique_ptr<ParameterPointers>   parameterPointers;
+    ParameterSnapshot                    parameterSnapshot;
+    bool                                 parameterSnapshotPrimed = false;
+    GlobalLfo                            globalLfo;
+    TuningStore                          tuning;
+    juce::CriticalSection                tuningLock;
+    int                                  tuningGroup = -1;
+    MicrotonalConfig                     tuningSource;  // copy of the mapping last compiled, to spot edits
+    std::shared_ptr<const CompiledTuning> tuningImport;
+    std::atomic<double>                  tuningSampleRate { 0.0 };
+    juce::MidiBuffer                     playableMidi;  // the events between two tuning messages
+
+    /* What each MIDI channel last sent, handed to the voices that start on it */
+    struct ChannelExpression
+    {
+        int pitchBendRange = defaultPitchBendRange;
+        int pressure = 0;
+        int timbre = 64;
+        int parameterNumber = 0x3fff;  // the selected RPN; 0x3fff is none
+        int bankSelect = 0;
+    };
 
+    ChannelExpression                    channelExpressions[16];
+    int                                  mpeMasterChannel = 0;  // 1 or 16 under MPE, else 0
+    double                               masterBend = 0.0;
+    std::shared_ptr<TuningLibrary>       tuningLibrary;
+    int                                  bankLibraryGeneration = -1;
+    int                                  bankBuilds = 0;  // guarded by tuningLock; the latest compileBank to start
+    MicrotonalConfig                     bankSources[EngineContext::numPresets];  // copies of what the bank was built from
+    std::shared_ptr<const CompiledTuning> bankImports[EngineContext::numPresets];
+    int                                  selectedTuning = -1;  // audio thread; the bank entry playing, if any
+    double                               tuningGlideSeconds = 0.0;
+    AdaptiveTuning                       adaptiveTuning;
+    bool                                 adaptiveTuningEnabled = false;
+    int                                  numAdaptiveNotes = -1;  // the held notes last analysed; -1 forces a new analysis
+    std::array<int, VoiceAllocator::maxVoices>    adaptiveVoices {};
+    std::array<double, VoiceAllocator::maxVoices> adaptiveFrequencies {};
+    std::array<double, VoiceAllocator::maxVoices> adaptiveOffsets {};
+    double                               nextNoteFrequency = 0.0;  // a MIDI 2.0 note-on's pitch, for the noteOn it calls
+    double                               hostBpm = 120.0;
+    double                               hostPpqPosition = 0.0;
+    bool                                 hostPlaying = false;
+    WavetableBank::Interpolation interpolation = WavetableBank::Interpolation::cubic;
+    WavetableBank::Interpolation renderInterpolation = WavetableBank::Interpolation::cubic;
+    EnvelopeGenerator::Curve     envelopeCurve = EnvelopeGenerator::Curve::linear;
+    int                          lfoControlInterval = 1;
 
-void incCurrentAngle(float& currentAngleR, float angleDeltaR);
\ No newline at end of file
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Synth)
+};
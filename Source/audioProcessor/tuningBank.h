@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    tuningBank.h
+    Created: 16 Oct 2026
+
+    Every tuning a MIDI program change can select. The mapper groups are
+    compiled ahead of time at the bank's sample rate; library tunings are
+    kept as the sample-rate-independent CompiledTunings the TuningLibrary
+    shares between every instance, and compiled into the playing table
+    only when selected, which never allocates. Built on a message thread
+    and handed over through TuningStore::publishBank; immutable once
+    published.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "tuningLibrary.h"
+#include "tuningTable.h"
+#include <memory>
+#include <vector>
+
+class TuningBank
+{
+public:
+    explicit TuningBank(double sampleRateToUse = 44100.0) : sampleRate(sampleRateToUse) {}
+
+    /* Appends an entry compiled at the bank's sample rate; all of these come before the library's */
+    void add(std::unique_ptr<TuningTable> table, const juce::String& name)
+    {
+        jassert(table != nullptr && library.empty());
+        tables.push_back(std::move(table));
+        names.add(name);
+    }
+
+    /* Appends library tunings, shared rather than copied */
+    void addLibrary(std::vector<std::shared_ptr<const CompiledTuning>> tunings)
+    {
+        library.insert(library.end(), tunings.begin(), tunings.end());
+    }
+
+    int size() const { return (int) (tables.size() + library.size()); }
+    const juce::String& getName(int index) const
+    {
+        return index < (int) tables.size() ? names.getReference(index) : library[(size_t) index - tables.size()]->name;
+    }
+
+    /* Audio thread: fills table with entry index */
+    void compileInto(int index, TuningTable& table) const
+    {
+        if (index < (int) tables.size())
+            table.copyFrom(*tables[(size_t) index]);
+        else
+            table.compile(*library[(size_t) index - tables.size()], sampleRate);
+    }
+
+private:
+    double                                              sampleRate;
+    std::vector<std::unique_ptr<TuningTable>>           tables;
+    juce::StringArray                                   names;
+    std::vector<std::shared_ptr<const CompiledTuning>>  library;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TuningBank)
+};
@@ -0,0 +1,301 @@
+/*
+  ==============================================================================
+
+    tuningLibrary.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "tuningLibrary.h"
+#include "scalaTuning.h"
+#include <algorithm>
+#include <set>
+
+namespace
+{
+    constexpr int cacheMagic = 0x4354544d;  // "MTTC"
+    constexpr int cacheVersion = 1;
+
+    juce::uint64 hashContents(const juce::String& scaleText, const juce::String& mappingText)
+    {
+        return (juce::uint64) (scaleText + "\n!kbm\n" + mappingText).hashCode64();
+    }
+}
+
+TuningLibrary::TuningLibrary(const juce::File& cacheFileToUse)
+    : juce::Thread("Tuning library"), cacheFile(cacheFileToUse)
+{
+}
+
+TuningLibrary::~TuningLibrary()
+{
+    stopThread(2000);
+
+    const juce::ScopedLock sl(lock);
+    if (cacheDirty)
+        writeCache();
+}
+
+std::shared_ptr<TuningLibrary> TuningLibrary::getShared()
+{
+    static juce::CriticalSection sharedLock;
+    static std::weak_ptr<TuningLibrary> shared;
+
+    const juce::ScopedLock sl(sharedLock);
+    if (auto library = shared.lock())
+        return library;
+
+    auto library = std::make_shared<TuningLibrary>(juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                                                       .getChildFile(ProjectInfo::companyName)
+                                                       .getChildFile("TuningCache.bin"));
+    library->scan(getDefaultDirectory());
+
+    shared = library;
+    return library;
+}
+
+juce::File TuningLibrary::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile(ProjectInfo::companyName)
+        .getChildFile("Tunings");
+}
+
+void TuningLibrary::scan(const juce::File& directory)
+{
+    stopThread(2000);
+    scanDirectory = directory;
+    startThread();
+}
+
+std::vector<std::shared_ptr<const CompiledTuning>> TuningLibrary::getTunings() const
+{
+    const juce::ScopedLock sl(lock);
+    return tunings;
+}
+
+TuningLibrary::Source TuningLibrary::getStamp(const juce::File& scaleFile)
+{
+    Source stamp;
+    stamp.scaleSize = scaleFile.getSize();
+    stamp.scaleModified = scaleFile.getLastModificationTime().toMilliseconds();
+
+    const auto mappingFile = scaleFile.withFileExtension("kbm");
+    stamp.mappingModified = mappingFile.existsAsFile() ? mappingFile.getLastModificationTime().toMilliseconds() : 0;
+    return stamp;
+}
+
+std::shared_ptr<const CompiledTuning> TuningLibrary::load(const juce::File& scaleFile, juce::String& error)
+{
+    const auto path = scaleFile.getFullPathName();
+    auto stamp = getStamp(scaleFile);
+
+    // unchanged since it was last compiled: no need to even read it
+    {
+        const juce::ScopedLock sl(lock);
+        auto source = sources.find(path);
+        if (source != sources.end()
+            && source->second.scaleSize == stamp.scaleSize
+            && source->second.scaleModified == stamp.scaleModified
+            && source->second.mappingModified == stamp.mappingModified)
+        {
+            auto tuning = compiled.find(source->second.contentHash);
+            if (tuning != compiled.end())
+                return tuning->second;
+        }
+    }
+
+    if (!scaleFile.existsAsFile())
+    {
+        error = "File not found";
+        return nullptr;
+    }
+
+    const auto mappingFile = scaleFile.withFileExtension("kbm");
+    stamp.contentHash = hashContents(scaleFile.loadFileAsString(),
+                                     mappingFile.existsAsFile() ? mappingFile.loadFileAsString() : juce::String());
+
+    // the same text under another name or after a touch: reuse what was compiled
+    std::shared_ptr<const CompiledTuning> tuning;
+    {
+        const juce::ScopedLock sl(lock);
+        auto found = compiled.find(stamp.contentHash);
+        if (found != compiled.end())
+            tuning = found->second;
+    }
+
+    if (tuning == nullptr)
+        tuning = compile(scaleFile, stamp.contentHash, error);
+
+    if (tuning == nullptr)
+        return nullptr;
+
+    const juce::ScopedLock sl(lock);
+    compiled[stamp.contentHash] = tuning;
+    sources[path] = stamp;
+    cacheDirty = true;
+    return tuning;
+}
+
+std::shared_ptr<const CompiledTuning> TuningLibrary::compile(const juce::File& scaleFile, juce::uint64 contentHash, juce::String& error)
+{
+    TuningMap map;
+    juce::String description;
+    if (!ScalaTuning::loadFile(scaleFile, map, description, error))
+        return nullptr;
+
+    auto tuning = std::make_shared<CompiledTuning>();
+    tuning->name = scaleFile.getFileNameWithoutExtension();
+    tuning->description = description;
+    tuning->contentHash = contentHash;
+
+    for (int note = 0; note < TuningTable::numKeys; ++note)
+    {
+        double frequency = 0.0;
+        tuning->frequencies[(size_t) note] = map.getFrequency(note, frequency) ? frequency : 0.0;
+    }
+
+    return tuning;
+}
+
+void TuningLibrary::run()
+{
+    if (!cacheRead)
+    {
+        const juce::ScopedLock sl(lock);
+        readCache();
+        cacheRead = true;
+    }
+
+    std::vector<std::shared_ptr<const CompiledTuning>> found;
+    std::set<juce::String> seen;
+    for (juce::DirectoryEntry entry : juce::RangedDirectoryIterator(scanDirectory, true, "*.scl", juce::File::findFiles))
+    {
+        if (threadShouldExit())
+            return;
+
+        juce::String error;
+        seen.insert(entry.getFile().getFullPathName());
+        if (auto tuning = load(entry.getFile(), error))
+            found.push_back(tuning);
+        else
+            DBG("Skipping " << entry.getFile().getFullPathName() << ": " << error);
+
+        // publish in batches so a big library shows up as it is read
+        if (!found.empty() && found.size() % 256 == 0)
+        {
+            const juce::ScopedLock sl(lock);
+            tunings = found;
+            ++generation;
+        }
+    }
+
+    std::sort(found.begin(), found.end(), [](const std::shared_ptr<const CompiledTuning>& a, const std::shared_ptr<const CompiledTuning>& b)
+    {
+        return a->name.compareNatural(b->name) < 0;
+    });
+
+    const juce::ScopedLock sl(lock);
+    tunings = std::move(found);
+    ++generation;
+
+    // forget files that have left the folder, then tables nothing refers to any more
+    std::set<juce::uint64> referenced;
+    for (auto source = sources.begin(); source != sources.end();)
+    {
+        if (juce::File(source->first).isAChildOf(scanDirectory) && seen.count(source->first) == 0)
+        {
+            source = sources.erase(source);
+            cacheDirty = true;
+            continue;
+        }
+        referenced.insert(source->second.contentHash);
+        ++source;
+    }
+
+    for (auto tuning = compiled.begin(); tuning != compiled.end();)
+    {
+        if (referenced.count(tuning->first) == 0)
+        {
+            tuning = compiled.erase(tuning);
+            cacheDirty = true;
+        }
+        else
+        {
+            ++tuning;
+        }
+    }
+
+    if (cacheDirty)
+        writeCache();
+}
+
+void TuningLibrary::readCache()
+{
+    juce::FileInputStream in(cacheFile);
+    if (!in.openedOk() || in.readInt() != cacheMagic || in.readInt() != cacheVersion)
+        return;
+
+    for (auto numSources = in.readInt(); numSources > 0 && !in.isExhausted(); --numSources)
+    {
+        const auto path = in.readString();
+        Source source;
+        source.scaleSize = in.readInt64();
+        source.scaleModified = in.readInt64();
+        source.mappingModified = in.readInt64();
+        source.contentHash = (juce::uint64) in.readInt64();
+        sources[path] = source;
+    }
+
+    for (auto numTunings = in.readInt(); numTunings > 0 && !in.isExhausted(); --numTunings)
+    {
+        auto tuning = std::make_shared<CompiledTuning>();
+        tuning->contentHash = (juce::uint64) in.readInt64();
+        tuning->name = in.readString();
+        tuning->description = in.readString();
+        for (auto& frequency : tuning->frequencies)
+            frequency = in.readDouble();
+
+        compiled[tuning->contentHash] = tuning;
+    }
+}
+
+void TuningLibrary::writeCache()
+{
+    cacheFile.getParentDirectory().createDirectory();
+    juce::TemporaryFile temp(cacheFile);
+
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+            return;
+
+        out.writeInt(cacheMagic);
+        out.writeInt(cacheVersion);
+
+        out.writeInt((int) sources.size());
+        for (auto& source : sources)
+        {
+            out.writeString(source.first);
+            out.writeInt64(source.second.scaleSize);
+            out.writeInt64(source.second.scaleModified);
+            out.writeInt64(source.second.mappingModified);
+            out.writeInt64((juce::int64) source.second.contentHash);
+        }
+
+        out.writeInt((int) compiled.size());
+        for (auto& entry : compiled)
+        {
+            const auto& tuning = *entry.second;
+            out.writeInt64((juce::int64) tuning.contentHash);
+            out.writeString(tuning.name);
+            out.writeString(tuning.description);
+            for (auto frequency : tuning.frequencies)
+                out.writeDouble(frequency);
+        }
+    }
+
+    if (temp.overwriteTargetFileWithTemporary())
+        cacheDirty = false;
+}
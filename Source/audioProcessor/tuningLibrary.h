@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    tuningLibrary.h
+    Created: 16 Oct 2026
+
+    A folder of Scala tunings, parsed on a background thread and kept as
+    compiled per-key frequency tables. The tables are cached on disk keyed
+    by a hash of the .scl and .kbm text, along with each file's size and
+    modification time, so reopening a library of thousands of scales only
+    reads the cache and never parses a file that hasn't changed.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "tuningTable.h"
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+/* A tuning reduced to the frequency of every key, independent of sample rate */
+struct CompiledTuning
+{
+    juce::String name;         // the .scl file name without its extension
+    juce::String description;  // the .scl's own description line
+    juce::uint64 contentHash = 0;
+    std::array<double, TuningTable::numKeys> frequencies {};  // 0 where the tuning leaves a key unmapped
+};
+
+class TuningLibrary : private juce::Thread
+{
+public:
+    explicit TuningLibrary(const juce::File& cacheFile);
+    ~TuningLibrary() override;
+
+    /* The process-wide library, which starts scanning getDefaultDirectory() when it is made */
+    static std::shared_ptr<TuningLibrary> getShared();
+    static juce::File getDefaultDirectory();
+
+    /* Scans directory and its subfolders for .scl files in the background, replacing any scan in progress */
+    void scan(const juce::File& directory);
+    bool isScanning() const { return isThreadRunning(); }
+
+    /* Loads one .scl (and its .kbm), from the cache if neither has changed. Returns nullptr and fills error if it can't be read */
+    std::shared_ptr<const CompiledTuning> load(const juce::File& scaleFile, juce::String& error);
+
+    /* The tunings the last scan found, sorted by name; fills in as a scan progresses */
+    std::vector<std::shared_ptr<const CompiledTuning>> getTunings() const;
+    /* Goes up whenever getTunings would return something different */
+    int getGeneration() const { return generation.load(); }
+
+private:
+    /* What a file looked like when it was compiled, so it can be skipped if it hasn't changed since */
+    struct Source
+    {
+        juce::int64  scaleSize = 0, scaleModified = 0, mappingModified = 0;
+        juce::uint64 contentHash = 0;
+    };
+
+    void run() override;
+
+    static Source getStamp(const juce::File& scaleFile);
+    std::shared_ptr<const CompiledTuning> compile(const juce::File& scaleFile, juce::uint64 contentHash, juce::String& error);
+
+    void readCache();
+    void writeCache();
+
+    juce::File cacheFile, scanDirectory;
+    bool       cacheRead = false;
+    bool       cacheDirty = false;
+
+    mutable juce::CriticalSection                                lock;  // guards everything below
+    std::map<juce::uint64, std::shared_ptr<const CompiledTuning>> compiled;  // by content hash
+    std::map<juce::String, Source>                                sources;   // by .scl path
+    std::vector<std::shared_ptr<const CompiledTuning>>            tunings;
+    std::atomic<int>                                              generation { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TuningLibrary)
+};
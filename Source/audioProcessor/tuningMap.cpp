@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    tuningMap.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "tuningMap.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+    int floorMod(int a, int b) { return a - floorDiv(a, b) * b; }
+
+    std::vector<double> getEqualRatios(int divisions, double periodRatio)
+    {
+        std::vector<double> degreeRatios;
+        degreeRatios.reserve((size_t) divisions - 1);
+        for (int i = 1; i < divisions; ++i)
+            degreeRatios.push_back(std::pow(periodRatio, (double) i / divisions));
+        return degreeRatios;
+    }
+}
+
+TuningMap::TuningMap()
+{
+    setScale(getEqualRatios(12, 2.0), 2.0);
+}
+
+TuningMap TuningMap::equalDivisions(int divisions, double baseFrequency, int baseKey, double periodRatio)
+{
+    jassert(divisions > 0 && periodRatio > 1.0);
+
+    TuningMap map;
+    map.setScale(getEqualRatios(std::max(1, divisions), periodRatio), periodRatio);
+    map.setLinearKeyboard(baseKey, baseKey, baseFrequency);
+    return map;
+}
+
+void TuningMap::setScale(const std::vector<double>& degreeRatios, double newPeriodRatio)
+{
+    jassert(newPeriodRatio > 0.0);
+
+    ratios.clear();
+    ratios.reserve(degreeRatios.size() + 1);
+    ratios.push_back(1.0);
+    ratios.insert(ratios.end(), degreeRatios.begin(), degreeRatios.end());
+    periodRatio = newPeriodRatio;
+}
+
+void TuningMap::setLinearKeyboard(int newMiddleKey, int newReferenceKey, double newReferenceFrequency)
+{
+    setKeyboard({}, 0, newMiddleKey, newReferenceKey, newReferenceFrequency);
+}
+
+void TuningMap::setKeyboard(const std::vector<int>& slotDegrees, int newOctaveDegree,
+                            int newMiddleKey, int newReferenceKey, double newReferenceFrequency)
+{
+    slots = slotDegrees;
+    octaveDegree = newOctaveDegree;
+    middleKey = newMiddleKey;
+    referenceKey = newReferenceKey;
+    referenceFrequency = newReferenceFrequency;
+}
+
+void TuningMap::setKeyRange(int first, int last)
+{
+    firstKey = juce::jlimit(0, numKeys - 1, first);
+    lastKey = juce::jlimit(0, numKeys - 1, last);
+}
+
+bool TuningMap::getKeyRatio(int midiNoteNumber, double& ratio) const
+{
+    const auto fromMiddle = midiNoteNumber - middleKey;
+    if (slots.empty())
+    {
+        ratio = getDegreeRatio(fromMiddle);
+        return true;
+    }
+
+    const auto mapSize = (int) slots.size();
+    const auto slotDegree = slots[(size_t) floorMod(fromMiddle, mapSize)];
+    if (slotDegree == unmappedSlot)
+        return false;
+
+    ratio = getDegreeRatio(slotDegree) * std::pow(getDegreeRatio(octaveDegree), floorDiv(fromMiddle, mapSize));
+    return true;
+}
+
+double TuningMap::getDegreeRatio(int degree) const
+{
+    const auto size = (int) ratios.size();
+    const auto periods = floorDiv(degree, size);
+    return ratios[(size_t) floorMod(degree, size)] * std::pow(periodRatio, periods);
+}
+
+bool TuningMap::getFrequency(int midiNoteNumber, double& frequency) const
+{
+    double ratio = 1.0;
+    if (midiNoteNumber < firstKey || midiNoteNumber > lastKey || !getKeyRatio(midiNoteNumber, ratio))
+        return false;
+
+    // an unmapped reference key still names a frequency; take it as degree 0's
+    double referenceRatio = 1.0;
+    if (!getKeyRatio(referenceKey, referenceRatio))
+        referenceRatio = 1.0;
+
+    frequency = referenceFrequency * ratio / referenceRatio;
+    return frequency > 0.0;
+}
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    tuningMap.h
+    Created: 16 Oct 2026
+
+    A tuning of any size: a scale of N degrees that repeats at a period
+    ratio, plus a keyboard map saying which degree each MIDI key plays.
+    The keyboard map repeats every mapSize keys, each repeat a further
+    step of the ratio of its formal octave degree, as in a Scala .kbm.
+    mapSize 0 means one degree per key, which is how an EDO is spread over
+    the whole keyboard. A TuningTable compiles this into one entry per key,
+    so how big the scale is never changes what a note-on costs. Degrees and
+    map slots are sized once when set, on the message thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include <vector>
+
+class TuningMap
+{
+public:
+    static constexpr int numKeys = 128;
+    static constexpr int unmappedSlot = -1;
+
+    /* 12-TET over the whole keyboard, with A4 (69) at 440 Hz */
+    TuningMap();
+
+    /* divisions equal steps of periodRatio, one step per key, with baseKey sounding baseFrequency */
+    static TuningMap equalDivisions(int divisions, double baseFrequency, int baseKey, double periodRatio = 2.0);
+
+    /* degreeRatios are degrees 1..N-1 as ratios of degree 0, which is always 1/1.
+       The scale repeats at periodRatio, so it has degreeRatios.size() + 1 degrees */
+    void setScale(const std::vector<double>& degreeRatios, double periodRatio);
+
+    /* One degree per key: middleKey plays degree 0 and referenceKey sounds referenceFrequency */
+    void setLinearKeyboard(int middleKey, int referenceKey, double referenceFrequency);
+
+    /* slotDegrees gives the degree for each of the mapSize keys from middleKey up,
+       or unmappedSlot. Each repeat of the map is transposed by the ratio of octaveDegree */
+    void setKeyboard(const std::vector<int>& slotDegrees, int octaveDegree,
+                     int middleKey, int referenceKey, double referenceFrequency);
+
+    /* Keys outside [first, last] are left unmapped */
+    void setKeyRange(int first, int last);
+
+    int    getScaleSize() const    { return (int) ratios.size(); }
+    double getPeriodRatio() const  { return periodRatio; }
+    int    getMapSize() const      { return (int) slots.size(); }
+
+    /* Frequency for a key. Returns false for keys the map leaves unmapped */
+    bool getFrequency(int midiNoteNumber, double& frequency) const;
+    /* Ratio of an absolute degree to degree 0, which may be negative, folding whole periods out */
+    double getDegreeRatio(int degree) const;
+
+private:
+    /* A key's ratio to degree 0 at middleKey. Returns false if its slot is unmapped */
+    bool getKeyRatio(int midiNoteNumber, double& ratio) const;
+
+    std::vector<double> ratios { 1.0 };  // degree 0 first, always 1/1
+    double              periodRatio = 2.0;
+
+    std::vector<int> slots;  // empty for one degree per key
+    int              octaveDegree = 0;
+    int              middleKey = 69;
+    int              referenceKey = 69;
+    double           referenceFrequency = 440.0;
+    int              firstKey = 0;
+    int              lastKey = numKeys - 1;
+
+    JUCE_LEAK_DETECTOR(TuningMap)
+};
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    tuningStore.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "tuningStore.h"
+#include <algorithm>
+
+TuningStore::TuningStore()
+{
+    published.store(new TuningTable());
+    auto* bank = new TuningBank();
+    publishedBank.store(bank);
+    pinnedBank = bank;
+}
+
+TuningStore::~TuningStore()
+{
+    delete published.load();
+    delete publishedBank.load();
+}
+
+void TuningStore::publish(std::unique_ptr<TuningTable> table)
+{
+    jassert(table != nullptr);
+    const juce::ScopedLock sl(writeLock);
+
+    // a reader that pins an epoch above this one loads the pointer after the
+    // exchange, so it can no longer be holding the old table
+    auto* old = published.exchange(table.release());
+    const auto replaced = advanceEpoch(tableEpoch);
+    retired.push_back({ replaced, std::unique_ptr<TuningTable>(old), nullptr });
+
+    reclaim();
+}
+
+void TuningStore::publishBank(std::unique_ptr<TuningBank> bank)
+{
+    jassert(bank != nullptr);
+    const juce::ScopedLock sl(writeLock);
+
+    // the reader keeps its bank between blocks, so it must see bankEpoch move
+    // no later than it pins the epoch that lets the old bank be freed
+    auto* old = publishedBank.exchange(bank.release());
+    const auto replaced = advanceEpoch(bankEpoch);
+    retired.push_back({ replaced, nullptr, std::unique_ptr<TuningBank>(old) });
+
+    reclaim();
+}
+
+juce::uint64 TuningStore::advanceEpoch(std::atomic<juce::uint64>& publishedEpoch)
+{
+    // writers hold writeLock, so nothing else moves the epoch in between
+    const auto replaced = epoch.load();
+    publishedEpoch.store(replaced + 1);
+    epoch.store(replaced + 1);
+    return replaced;
+}
+
+void TuningStore::reclaim()
+{
+    const auto pinned = readerEpoch.load();
+
+    retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                 [pinned](const Retired& r) { return r.epoch < pinned; }),
+                  retired.end());
+}
+
+int TuningStore::pinLatest()
+{
+    readerEpoch.store(epoch.load());
+
+    // compare epochs rather than pointers: a freed table's address can come back.
+    // Each is stored after its exchange, so seeing a new one means the pointer is new too
+    auto changes = 0;
+    const auto latestTable = tableEpoch.load();
+    if (latestTable != playingEpoch)
+    {
+        playing.copyFrom(*published.load());
+        playingEpoch = latestTable;
+        changes |= tableChanged;
+    }
+
+    const auto latestBank = bankEpoch.load();
+    if (latestBank != pinnedBankEpoch)
+    {
+        pinnedBank = publishedBank.load();
+        pinnedBankEpoch = latestBank;
+        changes |= bankChanged;
+    }
+
+    return changes;
+}
+
+bool TuningStore::select(int index)
+{
+    if (index < 0 || index >= pinnedBank->size())
+        return false;
+
+    pinnedBank->compileInto(index, playing);
+    return true;
+}
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    tuningStore.h
+    Created: 16 Oct 2026
+
+    Hands compiled TuningTables from the message thread to the audio thread
+    without locks. A table is immutable once published; publishing swaps an
+    atomic pointer and retires the previous table. Once per block the audio
+    thread pins the latest table and records the epoch it saw. A retired
+    table is only freed, on the writer's side, after the audio thread has
+    pinned a later epoch, so the audio thread never frees memory and never
+    reads a table after it is gone.
+
+    The audio thread plays from its own copy of the pinned table, taken
+    only when a new one has been published, so it can retune single keys
+    in place for MTS messages. Those retunes last until the next publish.
+
+    A TuningBank is published and retired the same way. Selecting one of
+    its entries copies or compiles it over the playing table, so a program
+    change costs one pass over the keys and never waits on the writer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "tuningBank.h"
+#include "tuningTable.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class TuningStore
+{
+public:
+    /* What a pinLatest call picked up */
+    enum Change
+    {
+        tableChanged = 1,
+        bankChanged  = 2
+    };
+
+    /* Starts with a 12-TET table and an empty bank already pinned */
+    TuningStore();
+    ~TuningStore();
+
+    /* Writer side: makes table the one the audio thread picks up at its next
+       block, and frees any retired table the audio thread has let go of */
+    void publish(std::unique_ptr<TuningTable> table);
+    /* Writer side: replaces the bank that select picks from */
+    void publishBank(std::unique_ptr<TuningBank> bank);
+
+    /* Audio thread, once per block: copies in the latest published table if it is new and
+       pins the latest bank. Returns the Change flags for what was new */
+    int pinLatest();
+    /* Audio thread: the table pinned by the last pinLatest, with any retunes since */
+    const TuningTable& getActive() const { return playing; }
+    /* Audio thread: changes one key of the playing table until the next table is published */
+    void retune(int midiNoteNumber, double frequency, double sampleRate) { playing.retune(midiNoteNumber, frequency, sampleRate); }
+
+    /* Audio thread: the bank pinned by the last pinLatest */
+    const TuningBank& getBank() const { return *pinnedBank; }
+    /* Audio thread: plays entry index of the pinned bank until the next table is published.
+       Returns false, leaving the playing table alone, if there is no such entry */
+    bool select(int index);
+
+private:
+    struct Retired
+    {
+        juce::uint64                 epoch;
+        std::unique_ptr<TuningTable> table;
+        std::unique_ptr<TuningBank>  bank;
+    };
+
+    /* Moves the epoch on, after the published epoch of whatever was just exchanged; returns the old epoch */
+    juce::uint64 advanceEpoch(std::atomic<juce::uint64>& publishedEpoch);
+    void reclaim();
+
+    std::atomic<TuningTable*>  published { nullptr };
+    std::atomic<TuningBank*>   publishedBank { nullptr };
+    std::atomic<juce::uint64>  epoch { 1 };
+    std::atomic<juce::uint64>  readerEpoch { 1 };
+    std::atomic<juce::uint64>  tableEpoch { 1 };  // the epoch each was last published at
+    std::atomic<juce::uint64>  bankEpoch { 1 };
+    TuningTable                playing;  // audio thread only, like everything down to retired
+    juce::uint64               playingEpoch = 1;
+    const TuningBank*          pinnedBank = nullptr;
+    juce::uint64               pinnedBankEpoch = 1;
+    std::vector<Retired>       retired;
+    juce::CriticalSection      writeLock;  // serialises writers only; the audio thread never takes it
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TuningStore)
+};
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    tuningTable.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "tuningTable.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "../components/microtonal/Microtonal.h"
+#include "tuningLibrary.h"
+
+TuningTable::TuningTable()
+{
+    compileDefault(44100.0);
+}
+
+double TuningTable::getDefaultFrequency(int midiNoteNumber)
+{
+    // the mapper lays its 12 keys out from C5 (72), with A5 (81) at 440 Hz
+    return 440.0 * std::pow(2.0, (midiNoteNumber - 81) / 12.0);
+}
+
+void TuningTable::setKey(int midiNoteNumber, double frequency, bool isMapped, double sampleRate)
+{
+    auto& key = keys[midiNoteNumber];
+    key.frequency = frequency;
+    key.cyclesPerSample = sampleRate > 0.0 ? frequency / sampleRate : 0.0;
+    key.phaseDelta = PhaseAccumulator::getIncrement(key.cyclesPerSample);
+    key.mapped = isMapped;
+    unmapped[(size_t) midiNoteNumber] = !isMapped;
+}
+
+void TuningTable::compile(const MicrotonalConfig& mapping, double sampleRate)
+{
+    // the scale's degrees run up and down from C5, one per key, repeating at its period
+    if (mapping.spanKeyboard)
+    {
+        compile(mapping.getTuningMap(), sampleRate);
+        return;
+    }
+
+    // the 12 mapped keys are a 12-slot keyboard map from C5 over a scale of their frequencies as
+    // degrees 1-12, with the period as degree 13; degree 0 is the 1/1 every TuningMap scale starts
+    // from. A frequency of 0 is how MicrotonalConfig marks an empty slot
+    std::vector<double> degreeRatios((size_t) mappedKeys, 1.0);
+    std::vector<int> slotDegrees((size_t) mappedKeys, TuningMap::unmappedSlot);
+    auto referenceKey = firstMappedKey;
+    auto referenceFrequency = 0.0;
+
+    for (int slot = 0; slot < mappedKeys; ++slot)
+    {
+        const auto frequency = mapping.frequencies[slot].frequency;
+        if (!(frequency > 0.0))
+            continue;
+
+        if (referenceFrequency == 0.0)
+        {
+            referenceKey = firstMappedKey + slot;
+            referenceFrequency = frequency;
+        }
+
+        degreeRatios[(size_t) slot] = frequency / referenceFrequency;
+        slotDegrees[(size_t) slot] = slot + 1;
+    }
+
+    TuningMap map;
+    map.setScale(degreeRatios, mapping.period);
+    map.setKeyboard(slotDegrees, mappedKeys + 1, firstMappedKey, referenceKey, referenceFrequency);
+    compile(map, sampleRate);
+}
+
+void TuningTable::compile(const TuningMap& map, double sampleRate)
+{
+    for (int note = 0; note < numKeys; ++note)
+    {
+        double frequency = 0.0;
+        if (map.getFrequency(note, frequency))
+            setKey(note, frequency, true, sampleRate);
+        else
+            setKey(note, getDefaultFrequency(note), false, sampleRate);
+    }
+}
+
+void TuningTable::compile(const CompiledTuning& tuning, double sampleRate)
+{
+    for (int note = 0; note < numKeys; ++note)
+    {
+        const auto frequency = tuning.frequencies[(size_t) note];
+        if (frequency > 0.0)
+            setKey(note, frequency, true, sampleRate);
+        else
+            setKey(note, getDefaultFrequency(note), false, sampleRate);
+    }
+}
+
+void TuningTable::compileDefault(double sampleRate)
+{
+    for (int note = 0; note < numKeys; ++note)
+        setKey(note, getDefaultFrequency(note), false, sampleRate);
+}
+
+void TuningTable::copyFrom(const TuningTable& other)
+{
+    std::copy(std::begin(other.keys), std::end(other.keys), std::begin(keys));
+    unmapped = other.unmapped;
+}
+
+void TuningTable::retune(int midiNoteNumber, double frequency, double sampleRate)
+{
+    if (frequency > 0.0)
+        setKey(midiNoteNumber & (numKeys - 1), frequency, true, sampleRate);
+}
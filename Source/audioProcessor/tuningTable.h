@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    tuningTable.h
+    Created: 16 Oct 2026
+
+    A MicrotonalConfig, TuningMap or imported tuning compiled into one entry per MIDI key,
+    holding the frequency and its phase increment at the current sample
+    rate, so a note-on is a table load instead of octave folding and two
+    pow calls, however many divisions the tuning has. Keys the tuning
+    leaves without a frequency fall back to 12-TET and are flagged as
+    unmapped rather than read from a zero frequency.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "phaseAccumulator.h"
+#include "tuningMap.h"
+#include <bitset>
+
+class MicrotonalConfig;
+struct CompiledTuning;
+
+class TuningTable
+{
+public:
+    static constexpr int numKeys = 128;
+    static constexpr int mappedKeys = 12;
+    static constexpr int firstMappedKey = 72;
+
+    struct Key
+    {
+        double       frequency = 0.0;
+        double       cyclesPerSample = 0.0;  // frequency / sampleRate, for detuned oscillators
+        juce::uint32 phaseDelta = 0;         // cyclesPerSample as a phase increment
+        bool         mapped = false;
+    };
+
+    /* Starts out as 12-TET at 44.1 kHz */
+    TuningTable();
+
+    /* Rebuilds every key from a mapping; call again whenever it or the sample rate changes */
+    void compile(const MicrotonalConfig& mapping, double sampleRate);
+    void compile(const TuningMap& map, double sampleRate);
+    void compile(const CompiledTuning& tuning, double sampleRate);
+    /* Plain 12-TET on every key */
+    void compileDefault(double sampleRate);
+
+    /* Overwrites every key with other's */
+    void copyFrom(const TuningTable& other);
+    /* Sets one key's frequency, as an MTS message does, leaving the rest alone */
+    void retune(int midiNoteNumber, double frequency, double sampleRate);
+
+    const Key& getKey(int midiNoteNumber) const { return keys[midiNoteNumber & (numKeys - 1)]; }
+
+    /* Keys filled from 12-TET because their pitch class had no frequency */
+    const std::bitset<numKeys>& getUnmappedKeys() const { return unmapped; }
+    bool isFullyMapped() const { return unmapped.none(); }
+
+private:
+    static double getDefaultFrequency(int midiNoteNumber);
+    void setKey(int midiNoteNumber, double frequency, bool isMapped, double sampleRate);
+
+    Key                  keys[numKeys];
+    std::bitset<numKeys> unmapped;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TuningTable)
+};
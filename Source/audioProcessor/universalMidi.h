@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    universalMidi.h
+    Created: 16 Oct 2026
+
+    Field access for MIDI 2.0 Universal MIDI Packets, on top of JUCE's
+    universal_midi_packets::Utils, read straight from the 32-bit words so
+    the audio thread never builds a message object. Only what MIDI 1.0
+    can't carry is decoded here: a note-on's velocity and pitch attribute
+    (7.9 fixed point), and the per-note controllers, pitch bend and
+    management. Everything else goes through
+    universal_midi_packets::Conversion::toMidi1. The group is ignored;
+    channels are numbered 1-16 as in juce::MidiMessage.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include <cmath>
+
+class UniversalMidi
+{
+public:
+    using Utils = juce::universal_midi_packets::Utils;
+
+    /* One packet of up to four words, at a sample position within a block */
+    struct Packet
+    {
+        juce::uint32 words[4] {};
+        int          samplePosition = 0;
+    };
+
+    enum MessageType
+    {
+        midi1ChannelVoice = 0x2,
+        midi2ChannelVoice = 0x4
+    };
+
+    /* Status nibbles of the MIDI 2.0 channel voice messages with no MIDI 1.0 equivalent */
+    enum Status
+    {
+        registeredPerNoteController = 0x0,
+        assignablePerNoteController = 0x1,
+        perNotePitchBend            = 0x6,
+        noteOff                     = 0x8,
+        noteOn                      = 0x9,
+        perNoteManagement           = 0xf
+    };
+
+    /* Note-on attribute type carrying the note's pitch */
+    static constexpr int pitchAttribute = 0x3;
+    /* Registered per-note controller setting a note's pitch, 7.25 fixed point */
+    static constexpr int pitchController = 3;
+
+    static juce::universal_midi_packets::View getView(const Packet& packet)
+    {
+        return juce::universal_midi_packets::View(packet.words);
+    }
+
+    static int getMessageType(const Packet& packet) { return Utils::getMessageType(packet.words[0]); }
+    static int getStatus(const Packet& packet)      { return Utils::getStatus(packet.words[0]); }
+    static int getChannel(const Packet& packet)     { return Utils::getChannel(packet.words[0]) + 1; }
+    static int getNoteNumber(const Packet& packet)  { return Utils::U8<2>::get(packet.words[0]) & 0x7f; }
+    static int getIndex(const Packet& packet)       { return Utils::U8<3>::get(packet.words[0]); }
+
+    /* Note-on/off velocity and attribute */
+    static float getVelocity(const Packet& packet)      { return float(Utils::U16<0>::get(packet.words[1])) / 65535.0f; }
+    static int   getAttributeType(const Packet& packet) { return Utils::U8<3>::get(packet.words[0]); }
+
+    /* A pitch attribute as a 12-TET note number with a fraction, A4 = 69 at 440 Hz */
+    static double getPitch7_9(const Packet& packet) { return double(Utils::U16<1>::get(packet.words[1])) / 512.0; }
+    /* A pitch controller's value in the same units */
+    static double getPitch7_25(const Packet& packet) { return double(packet.words[1]) / 33554432.0; }
+
+    /* The frequency of a fractional 12-TET note number */
+    static double getFrequency(double pitch) { return 440.0 * std::pow(2.0, (pitch - 69.0) / 12.0); }
+
+    /* Bipolar 32-bit data, centred on 0x80000000, as -1 to 1 */
+    static double getBipolarData(const Packet& packet) { return (double(packet.words[1]) - 2147483648.0) / 2147483648.0; }
+
+    /* Per-note management flags */
+    static bool isDetach(const Packet& packet) { return (Utils::U8<3>::get(packet.words[0]) & 0x2) != 0; }
+    static bool isReset(const Packet& packet)  { return (Utils::U8<3>::get(packet.words[0]) & 0x1) != 0; }
+};
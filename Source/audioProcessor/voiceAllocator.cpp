@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    voiceAllocator.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "voiceAllocator.h"
+
+void VoiceAllocator::setNumVoices(int numVoices)
+{
+    jassert(juce::isPositiveAndNotGreaterThan(numVoices, maxVoices));
+
+    slots.assign((size_t) numVoices, Slot());
+    std::fill(std::begin(keyVoices), std::end(keyVoices), none);
+    activeHead = activeTail = none;
+    numActive = 0;
+
+    // the free stack is threaded through next, lowest index on top
+    freeHead = none;
+    for (int v = numVoices; --v >= 0;)
+    {
+        slots[(size_t) v].next = freeHead;
+        freeHead = v;
+    }
+}
+
+int VoiceAllocator::allocate()
+{
+    auto voice = freeHead;
+    if (voice != none)
+        freeHead = slots[(size_t) voice].next;
+    return voice;
+}
+
+void VoiceAllocator::activate(int voice, int midiChannel, int midiNoteNumber)
+{
+    auto& slot = slots[(size_t) voice];
+    if (slot.active)
+        unlink(voice);
+    else
+        ++numActive;
+
+    slot.active = true;
+    slot.key = getKey(midiChannel, midiNoteNumber);
+    slot.prev = activeTail;
+    slot.next = none;
+
+    if (activeTail != none)
+        slots[(size_t) activeTail].next = voice;
+    else
+        activeHead = voice;
+    activeTail = voice;
+
+    keyVoices[slot.key] = voice;
+}
+
+void VoiceAllocator::release(int voice)
+{
+    auto& slot = slots[(size_t) voice];
+    if (!slot.active)
+        return;
+
+    unlink(voice);
+    --numActive;
+    slot.active = false;
+    slot.next = freeHead;
+    freeHead = voice;
+}
+
+void VoiceAllocator::unlink(int voice)
+{
+    auto& slot = slots[(size_t) voice];
+
+    if (slot.prev != none)
+        slots[(size_t) slot.prev].next = slot.next;
+    else
+        activeHead = slot.next;
+
+    if (slot.next != none)
+        slots[(size_t) slot.next].prev = slot.prev;
+    else
+        activeTail = slot.prev;
+
+    // a newer voice on the same key keeps its entry
+    if (keyVoices[slot.key] == voice)
+        keyVoices[slot.key] = none;
+
+    slot.key = none;
+    slot.prev = none;
+    slot.next = none;
+}
+
+int VoiceAllocator::findVoice(int midiChannel, int midiNoteNumber) const
+{
+    return keyVoices[getKey(midiChannel, midiNoteNumber)];
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    voiceAllocator.h
+    Created: 16 Oct 2026
+
+    Bookkeeping behind Synth's note-on and note-off. Voices are indices
+    threaded through two intrusive lists: a free stack and an active list
+    kept in start order, so the oldest voice is always at its head. A
+    (channel, note) table points at the voice last started for each key.
+    Allocating, activating, releasing and looking up a key are all O(1);
+    only the quietest stealing policy walks the active list, and only when
+    every voice is busy.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include <vector>
+
+class VoiceAllocator
+{
+public:
+    enum class StealPolicy
+    {
+        oldest,    // the voice started longest ago
+        quietest,  // the voice whose envelope is lowest
+        sameNote   // a voice still sounding the same key, else the oldest
+    };
+
+    static constexpr int maxVoices = 256;
+    static constexpr int none = -1;
+
+    VoiceAllocator() { setNumVoices(0); }
+
+    /* Frees every voice; allocates, so call it away from the audio thread */
+    void setNumVoices(int numVoices);
+    int  getNumVoices() const { return (int) slots.size(); }
+
+    /* Pops a free voice, or returns none when every voice is active */
+    int  allocate();
+    /* Makes the voice the newest in the active list, playing the given key; a
+       voice that is already active (a stolen one) just moves to the end */
+    void activate(int voice, int midiChannel, int midiNoteNumber);
+    /* Moves an active voice back to the free stack */
+    void release(int voice);
+
+    bool isActive(int voice) const { return slots[(size_t) voice].active; }
+    /* The voice last started on this key, or none */
+    int  findVoice(int midiChannel, int midiNoteNumber) const;
+    int  getNumActive() const { return numActive; }
+    int  getOldest() const { return activeHead; }
+    int  getNext(int voice) const { return slots[(size_t) voice].next; }
+
+private:
+    struct Slot
+    {
+        int  prev = none;
+        int  next = none;
+        int  key = none;
+        bool active = false;
+    };
+
+    void unlink(int voice);
+
+    static int getKey(int midiChannel, int midiNoteNumber)
+    {
+        return (juce::jlimit(1, 16, midiChannel) - 1) * 128 + (midiNoteNumber & 127);
+    }
+
+    std::vector<Slot> slots;
+    int               keyVoices[16 * 128];
+    int               freeHead = none;
+    int               activeHead = none;
+    int               activeTail = none;
+    int               numActive = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoiceAllocator)
+};
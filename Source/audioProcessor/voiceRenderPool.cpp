@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    voiceRenderPool.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "voiceRenderPool.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    inline void pause() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && (JUCE_GCC || JUCE_CLANG)
+        __asm__ __volatile__ ("yield");
+       #endif
+    }
+}
+
+VoiceRenderPool::VoiceRenderPool(int numWorkers)
+{
+    for (int i = 0; i < numWorkers; ++i)
+        workers.push_back(std::make_unique<Worker>(*this, i));
+
+    for (auto& worker : workers)
+    {
+       #if JUCE_VERSION >= 0x70003
+        worker->startRealtimeThread(juce::Thread::RealtimeOptions{});
+       #else
+        worker->startThread(10);
+       #endif
+    }
+}
+
+VoiceRenderPool::~VoiceRenderPool()
+{
+    for (auto& worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+
+    for (auto& worker : workers)
+        worker->stopThread(-1);
+}
+
+void VoiceRenderPool::run(int numJobs, Job job, void* context)
+{
+    jassert(juce::isPositiveAndNotGreaterThan(numJobs, maxJobs));
+    if (numJobs <= 0)
+        return;
+
+    currentJob = job;
+    currentContext = context;
+    jobsRemaining.store(numJobs, std::memory_order_relaxed);
+    ticket.store(makeTicket(++generation, numJobs, 0), std::memory_order_release);
+
+    // only sleeping workers need the event; spinning ones see the ticket by themselves
+    for (auto& worker : workers)
+        if (worker->sleeping.exchange(false))
+            worker->notify();
+
+    runJobs();
+
+    while (jobsRemaining.load(std::memory_order_acquire) > 0)
+        pause();
+}
+
+bool VoiceRenderPool::runJobs()
+{
+    bool claimedAny = false;
+    auto current = ticket.load(std::memory_order_acquire);
+
+    while (hasUnclaimedJobs(current))
+    {
+        if (!ticket.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            continue;
+
+        currentJob(currentContext, int(current & 0xffff));
+        jobsRemaining.fetch_sub(1, std::memory_order_acq_rel);
+        claimedAny = true;
+
+        current = ticket.load(std::memory_order_acquire);
+    }
+
+    return claimedAny;
+}
+
+void VoiceRenderPool::workerLoop(Worker& worker)
+{
+    while (!worker.threadShouldExit())
+    {
+        if (runJobs())
+            continue;
+
+        bool found = false;
+        for (int i = 0; i < spinIterations && !found; ++i)
+        {
+            pause();
+            found = hasUnclaimedJobs(ticket.load(std::memory_order_acquire));
+        }
+
+        if (found)
+            continue;
+
+        // run() clears the flag before signalling, so a batch published
+        // between this check and wait() still wakes the worker
+        worker.sleeping.store(true);
+        if (!hasUnclaimedJobs(ticket.load()) && !worker.threadShouldExit())
+            worker.wait(-1);
+        worker.sleeping.store(false);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    voiceRenderPool.h
+    Created: 16 Oct 2026
+
+    Fixed set of worker threads that Synth hands its active voices to.
+    run() publishes a batch of jobs through one atomic ticket; workers and
+    the calling audio thread claim them with a compare-exchange until the
+    batch is empty, so idle threads take work from busy ones and nothing
+    locks or allocates once the pool exists. Workers are real-time priority
+    juce::Threads, so the audio thread never waits on a job running at normal
+    priority; they spin briefly for the next batch before sleeping on their
+    thread's event. The audio thread never sleeps, it spins until every
+    claimed job has finished.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class VoiceRenderPool
+{
+public:
+    using Job = void (*)(void* context, int index);
+    static constexpr int maxJobs = 0xffff;
+
+    /* Starts the threads; construct and destroy away from the audio thread */
+    explicit VoiceRenderPool(int numWorkers);
+    ~VoiceRenderPool();
+
+    int getNumWorkers() const { return (int) workers.size(); }
+
+    /* Calls job(context, i) for every i below numJobs, spread over the workers and
+       the calling thread, and returns once all of them are done */
+    void run(int numJobs, Job job, void* context);
+
+private:
+    struct Worker : public juce::Thread
+    {
+        Worker(VoiceRenderPool& poolToUse, int index)
+            : juce::Thread("Voice render " + juce::String(index)), pool(poolToUse) {}
+
+        void run() override { pool.workerLoop(*this); }
+
+        VoiceRenderPool&  pool;
+        std::atomic<bool> sleeping { false };
+    };
+
+    static constexpr int spinIterations = 2000;
+
+    // generation in the top 32 bits, job count and next index in 16 bits each
+    static juce::uint64 makeTicket(juce::uint32 generation, int numJobs, int index)
+    {
+        return (juce::uint64(generation) << 32) | (juce::uint64(numJobs) << 16) | juce::uint64(index);
+    }
+
+    static bool hasUnclaimedJobs(juce::uint64 ticket)
+    {
+        return (ticket & 0xffff) < ((ticket >> 16) & 0xffff);
+    }
+
+    void workerLoop(Worker& worker);
+    bool runJobs();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<juce::uint64> ticket { 0 };
+    std::atomic<int>          jobsRemaining { 0 };
+    Job                       currentJob = nullptr;
+    void*                     currentContext = nullptr;
+    juce::uint32              generation = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoiceRenderPool)
+};
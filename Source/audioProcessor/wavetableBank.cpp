@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+
+    wavetableBank.cpp
+    Created: 16 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "wavetableBank.h"
+
+namespace
+{
+    // complex bin n of the real forward FFT for a cos(2 pi n p) + b sin(2 pi n p)
+    void setHarmonic(std::vector<float>& spectrum, int harmonic, double a, double b)
+    {
+        const auto scale = WavetableBank::tableSize / 2.0;
+        spectrum[(size_t) harmonic * 2] = float(a * scale);
+        spectrum[(size_t) harmonic * 2 + 1] = float(-b * scale);
+    }
+
+    std::vector<float> parseCustomWave(const juce::String& text)
+    {
+        std::vector<float> points;
+        for (auto& token : juce::StringArray::fromTokens(text, " \t\r\n", ""))
+            if (token.isNotEmpty())
+                points.push_back(token.getFloatValue());
+
+        return points;
+    }
+
+    // custom_waves/cuN.txt in the working directory wins so edited waves still apply,
+    // otherwise the copy compiled into BinaryData is used
+    std::vector<float> loadCustomWave(int index)
+    {
+        auto fileName = "cu" + juce::String(index + 1) + ".txt";
+        auto file = juce::File::getCurrentWorkingDirectory().getChildFile("custom_waves").getChildFile(fileName);
+        if (file.existsAsFile())
+            return parseCustomWave(file.loadFileAsString());
+
+        int size = 0;
+        if (auto* data = BinaryData::getNamedResource(fileName.replaceCharacter('.', '_').toRawUTF8(), size))
+            return parseCustomWave(juce::String::fromUTF8(data, size));
+
+        return {};
+    }
+}
+
+WavetableBank::WavetableBank()
+{
+    const auto pi = juce::MathConstants<double>::pi;
+    const auto maxHarmonic = tableSize / 4;
+
+    std::vector<float> sine((size_t) tableSize + 2), square(sine.size()), saw(sine.size()), triangle(sine.size());
+
+    // same phase and polarity as the naive shapes the oscillators used to compute
+    setHarmonic(sine, 1, 0.0, 1.0);
+    for (int n = 1; n <= maxHarmonic; ++n)
+    {
+        setHarmonic(saw, n, 0.0, -2.0 / (pi * n));
+
+        if (n % 2 == 1)
+        {
+            setHarmonic(square, n, 0.0, -4.0 / (pi * n));
+            setHarmonic(triangle, n, -8.0 / (pi * pi * n * n), 0.0);
+        }
+    }
+
+    buildLevels(0, sine);
+    buildLevels(1, square);
+    buildLevels(2, saw);
+    buildLevels(3, triangle);
+}
+
+std::shared_ptr<const WavetableBank> WavetableBank::getShared()
+{
+    static juce::CriticalSection lock;
+    static std::weak_ptr<const WavetableBank> shared;
+
+    const juce::ScopedLock sl(lock);
+    if (auto bank = shared.lock())
+        return bank;
+
+    auto bank = std::make_shared<WavetableBank>();
+    for (int i = 0; i < numCustomWaves; ++i)
+        bank->setCustomWave(i, loadCustomWave(i));
+
+    shared = bank;
+    return bank;
+}
+
+void WavetableBank::setCustomWave(int index, const std::vector<float>& points)
+{
+    jassert(juce::isPositiveAndBelow(index, numCustomWaves));
+    auto& levels = tables[firstCustomWave + index];
+
+    if (points.size() < 2)
+    {
+        levels.clear();
+        return;
+    }
+
+    juce::dsp::FFT fft(tableBits);
+    std::vector<float> work((size_t) tableSize * 2, 0.0f);
+
+    const auto lastPoint = double(points.size() - 1);
+    for (int i = 0; i < tableSize; ++i)
+    {
+        auto position = lastPoint * i / tableSize;
+        auto point = (size_t) position;
+        auto frac = float(position - double(point));
+        work[(size_t) i] = points[point] + (points[point + 1] - points[point]) * frac;
+    }
+
+    fft.performRealOnlyForwardTransform(work.data(), true);
+    work.resize((size_t) tableSize + 2);
+    buildLevels(firstCustomWave + index, work);
+}
+
+void WavetableBank::buildLevels(int waveForm, const std::vector<float>& spectrum)
+{
+    juce::dsp::FFT fft(tableBits);
+    std::vector<float> work((size_t) tableSize * 2);
+
+    auto& levels = tables[waveForm];
+    levels.assign((size_t) (numLevels * levelStride), 0.0f);
+
+    for (int level = 0; level < numLevels; ++level)
+    {
+        const auto maxHarmonic = (tableSize / 4) >> level;
+
+        std::fill(work.begin(), work.end(), 0.0f);
+        for (int n = 0; n <= maxHarmonic; ++n)
+        {
+            work[(size_t) n * 2] = spectrum[(size_t) n * 2];
+            work[(size_t) n * 2 + 1] = n == 0 ? 0.0f : spectrum[(size_t) n * 2 + 1];
+        }
+
+        for (int n = 1; n <= maxHarmonic; ++n)
+        {
+            work[(size_t) (tableSize - n) * 2] = work[(size_t) n * 2];
+            work[(size_t) (tableSize - n) * 2 + 1] = -work[(size_t) n * 2 + 1];
+        }
+
+        fft.performRealOnlyInverseTransform(work.data());
+
+        auto* table = levels.data() + level * levelStride + guardBefore;
+        std::copy(work.begin(), work.begin() + tableSize, table);
+        table[-1] = table[tableSize - 1];
+        table[tableSize] = table[0];
+        table[tableSize + 1] = table[1];
+    }
+}
+
+bool WavetableBank::hasWave(int waveForm) const
+{
+    return juce::isPositiveAndBelow(waveForm, numWaveForms) && !tables[waveForm].empty();
+}
+
+const float* WavetableBank::getTable(int waveForm, juce::uint32 phaseDelta) const
+{
+    if (!hasWave(waveForm))
+        return nullptr;
+
+    return tables[waveForm].data() + getLevel(phaseDelta) * levelStride + guardBefore;
+}
+
+const float* WavetableBank::getSilence()
+{
+    static const std::vector<float> silence((size_t) levelStride, 0.0f);
+    return silence.data() + guardBefore;
+}
+
+int WavetableBank::getLevel(juce::uint32 phaseDelta)
+{
+    // level n holds 1024 >> n harmonics, which stay below Nyquist while phaseDelta <= 2^(21 + n)
+    int level = 0;
+    while (level < numLevels - 1 && phaseDelta > (1u << (21 + level)))
+        ++level;
+
+    return level;
+}
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    wavetableBank.h
+    Created: 16 Oct 2026
+
+    Band-limited, per-octave mipmapped tables for every wave_form choice
+    (Sin, Squ, Saw, Tri, Cu1..Cu7). Each level keeps only the harmonics that
+    stay below Nyquist for the increments it is picked for, and carries guard
+    points so a read never has to wrap its index. One immutable bank is
+    shared by every voice and plugin instance in the process.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "phaseAccumulator.h"
+#include <memory>
+#include <vector>
+
+class WavetableBank
+{
+public:
+    enum class Interpolation { truncate, linear, cubic };
+
+    static constexpr int numWaveForms = 11;
+    static constexpr int numCustomWaves = 7;
+    static constexpr int firstCustomWave = 4;
+    static constexpr int tableBits = 12;
+    static constexpr int tableSize = 1 << tableBits;
+    static constexpr int numLevels = 11;           // 1024 harmonics down to 1
+    static constexpr int guardBefore = 1;
+    static constexpr int guardAfter = 2;
+    static constexpr int levelStride = guardBefore + tableSize + guardAfter;
+
+    /* Builds Sin, Squ, Saw and Tri; use getShared() for a bank with the custom waves loaded */
+    WavetableBank();
+
+    /* The process-wide bank. It is built and the custom waves parsed on the first call,
+       and freed again once the last holder lets go */
+    static std::shared_ptr<const WavetableBank> getShared();
+
+    bool hasWave(int waveForm) const;
+
+    /* Table of the level suited to phaseDelta, or nullptr if the wave is not loaded */
+    const float* getTable(int waveForm, juce::uint32 phaseDelta) const;
+
+    /* A silent table that is always safe to read */
+    static const float* getSilence();
+
+    static int getLevel(juce::uint32 phaseDelta);
+
+    template <Interpolation interpolation>
+    static float read(const float* table, juce::uint32 phase)
+    {
+        auto index = int(phase >> (32 - tableBits));
+
+        if constexpr (interpolation == Interpolation::truncate)
+        {
+            return table[index];
+        }
+        else
+        {
+            auto frac = PhaseAccumulator::toUnit(phase << tableBits);
+
+            if constexpr (interpolation == Interpolation::linear)
+            {
+                return table[index] + (table[index + 1] - table[index]) * frac;
+            }
+            else
+            {
+                // 4-point, 3rd-order Hermite
+                auto xm1 = table[index - 1], x0 = table[index], x1 = table[index + 1], x2 = table[index + 2];
+                auto c1 = 0.5f * (x1 - xm1);
+                auto c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+                auto c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+                return ((c3 * frac + c2) * frac + c1) * frac + x0;
+            }
+        }
+    }
+
+private:
+    /* Builds Cu<index + 1> from one cycle of points, linearly interpolated as the raw wave would be */
+    void setCustomWave(int index, const std::vector<float>& points);
+
+    /* spectrum holds tableSize / 2 + 1 complex bins as produced by a real forward FFT */
+    void buildLevels(int waveForm, const std::vector<float>& spectrum);
+
+    std::vector<float> tables[numWaveForms];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableBank)
+};
@@ -1,4 +1,6 @@
+#pragma once
 #include <string>
+#include "../../audioProcessor/tuningMap.h"
 using namespace std;
 /* Contains the mapped frequency and its index relative to the list of all frequencies in a division */
 class Mapping {
@@ -10,9 +12,18 @@ public:
 /* Microtonal class containing configuration save/load methods, the base frequency, total divisions, and a list of mapped frequencies */
 class MicrotonalConfig {
 public:
+    /* Largest number of divisions of the octave the mapper accepts */
+    static const int maxDivisions = 1200;
+
     double base_frequency;
     double divisions;
     Mapping frequencies[12];
+    /* When set, the 12 frequencies are ignored and every key is one division away from its neighbour, with C5 on the base frequency */
+    bool spanKeyboard = false;
+    /* Ratio the divisions repeat at: 2 for an octave, 3 for Bohlen-Pierce's tritave */
+    double period = 2.0;
+    /* Degrees 1 to N-1 as ratios of degree 0, for a scale that isn't equal divisions of the period; empty for equal divisions */
+    vector<double> scale;
 
     /* Default constructor */
     MicrotonalConfig() {
@@ -74,6 +85,8 @@ public:
       * Return: true or false
     */
     bool isMapped() {
+        if (spanKeyboard) return true;
+
         for (Mapping m : frequencies) {
             if (m.frequency != NULL) return true;
         }
@@ -88,16 +101,28 @@ public:
       * Return: A vector containing all the frequencies that can be mapped
     */
     vector<double> getAllFrequencies() {
+        const TuningMap map = getTuningMap();
         vector<double> freq;
 
 		for (int i = 0; i <= divisions; i++) {
-			double step_calc = (i / divisions);
-			freq.push_back(base_frequency * pow(2, step_calc));
+			freq.push_back(base_frequency * map.getDegreeRatio(i));
 		}
 
         return freq;
     }
 
+    /*
+      * Description: Builds the scale, equal divisions of the period unless a scale is set, one degree per key with C5 (72) on the base frequency
+      * Is generated by JUCE: No
+      * Parameters: None
+      * Return: The TuningMap a whole keyboard mapping is compiled from
+    */
+    TuningMap getTuningMap() const {
+        TuningMap map = TuningMap::equalDivisions(juce::jmax(1, (int)divisions), base_frequency, 72, period);
+        if (!scale.empty()) map.setScale(scale, period);
+        return map;
+    }
+
     /*
       * Description: Used to generate config file structure for saving and loading
       * Is generated by JUCE: No
@@ -108,6 +133,16 @@ public:
         juce::ValueTree t{"Preset"};
         t.setProperty("base_frequency", juce::String(base_frequency), nullptr);
         t.setProperty("total_divisions", juce::String(divisions), nullptr);
+        t.setProperty("span_keyboard", spanKeyboard, nullptr);
+        t.setProperty("period", juce::String(period, 9), nullptr);
+
+        /* A scale is kept in cents, which reads back through ScalaTuning::parsePitchList with the period last */
+        if (!scale.empty()) {
+            juce::String pitches;
+            for (double ratio : scale) pitches << juce::String(1200.0 * log2(ratio), 6) << " ";
+            pitches << juce::String(1200.0 * log2(period), 6);
+            t.setProperty("scale", pitches, nullptr);
+        }
 
         for (int i = 0; i < 12; i++) {
             if (frequencies[i].frequency == NULL) continue;
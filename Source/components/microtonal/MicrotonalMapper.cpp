@@ -5,24 +5,20 @@
 #include <regex>
 using namespace std;
 
-/* Program-wide variables */
-MicrotonalConfig microtonalMappings[7];  // Stores the mappings that are used by the synth
-extern juce::String microtonalPresetNames[7]; // Stores the mapping preset names to be displayed when a preset is loaded
-atomic<int> mappingIndex; // Stores currently active mapping
-
 /*
   * Description: Microtonal mapping window contructor
   * Is generated by JUCE: No
-  * Parameters: The index for which mapping is being edited
+  * Parameters: The plugin instance's mappings, and the index for which mapping is being edited
   * Return: N/A
 */
-MainContentComponent::MainContentComponent(int index) : synthAudioSource(keyboardState),
+MainContentComponent::MainContentComponent(EngineContext& contextToEdit, int index) : context(contextToEdit),
+    mapping(contextToEdit.microtonalMappings[index]),
+    synthAudioSource(keyboardState, previewTable),
     keyboardComponent(keyboardState, juce::MidiKeyboardComponent::horizontalKeyboard)
 {
         /* Set mapping preset number and total divisions of the octave*/
         this->index = index;
-        divisions = (int)microtonalMappings[mappingIndex].divisions;
-        mappingIndex = index;
+        divisions = (int)mapping.divisions;
 
         /* Render keyboard container on microtonal window */
         keyboardWindow.setColour(juce::TextButton::buttonColourId, juce::Colours::grey);
@@ -32,7 +28,7 @@ MainContentComponent::MainContentComponent(int index) : synthAudioSource(keyboar
 
         /* Render total divisions input box */
         divisionInput.setFont(juce::Font(20.0f, juce::Font::bold));
-        divisionInput.setText(to_string((int)microtonalMappings[mappingIndex].divisions), juce::dontSendNotification);
+        divisionInput.setText(to_string((int)mapping.divisions), juce::dontSendNotification);
         divisionInput.setColour(juce::Label::textColourId, juce::Colours::black);
         divisionInput.setJustificationType(juce::Justification::centred);
         divisionInput.setEditable(true);
@@ -52,7 +48,7 @@ MainContentComponent::MainContentComponent(int index) : synthAudioSource(keyboar
 
         /* Render total divisions label */
         divisionLabel.setFont(juce::Font(20.0f, juce::Font::bold));
-        divisionLabel.setText("Notes per octave:", juce::dontSendNotification);
+        divisionLabel.setText("Notes per period:", juce::dontSendNotification);
         divisionLabel.attachToComponent(&divisionInput, true);
         divisionLabel.setColour(juce::Label::textColourId, colours[3]);
         divisionLabel.setColour(juce::Label::backgroundColourId, colours[backgroundColor]);
@@ -62,7 +58,7 @@ MainContentComponent::MainContentComponent(int index) : synthAudioSource(keyboar
 
         /* Render base frequency input box */
         baseFreqInput.setFont(juce::Font(18.0f, juce::Font::bold));
-        baseFreqInput.setText(to_string(microtonalMappings[mappingIndex].base_frequency), juce::dontSendNotification);
+        baseFreqInput.setText(to_string(mapping.base_frequency), juce::dontSendNotification);
         baseFreqInput.setColour(juce::Label::textColourId, juce::Colours::black);
         baseFreqInput.setColour(juce::Label::outlineColourId, colours[inputOutlineTextColor]);
         baseFreqInput.setColour(juce::Label::backgroundColourId, colours[inputBackgroundColor]);
@@ -98,6 +94,15 @@ MainContentComponent::MainContentComponent(int index) : synthAudioSource(keyboar
         generateFrequencies.setMouseCursor(juce::MouseCursor::PointingHandCursor);
         addAndMakeVisible(generateFrequencies);
 
+        /* Render whole keyboard toggle, which spreads the divisions over every key instead of mapping 12 */
+        spanKeyboardToggle.setButtonText("Whole keyboard");
+        spanKeyboardToggle.setToggleState(mapping.spanKeyboard, juce::dontSendNotification);
+        spanKeyboardToggle.setColour(juce::ToggleButton::textColourId, colours[inputOutlineTextColor]);
+        spanKeyboardToggle.setColour(juce::ToggleButton::tickColourId, colours[inputOutlineTextColor]);
+        spanKeyboardToggle.onClick = [this] { mapping.spanKeyboard = spanKeyboardToggle.getToggleState(); clearImportedTuning(); updateUnmappedKeys(); };
+        spanKeyboardToggle.setMouseCursor(juce::MouseCursor::PointingHandCursor);
+        addAndMakeVisible(spanKeyboardToggle);
+
         /* Render keyboard and enable sound */
         addAndMakeVisible(keyboardComponent);
         setAudioChannels(0, 2);
@@ -137,6 +142,13 @@ MainContentComponent::MainContentComponent(int index) : synthAudioSource(keyboar
         savePreset.addListener(this);
         savePreset.setMouseCursor(juce::MouseCursor::PointingHandCursor);
         addAndMakeVisible(savePreset);
+
+        /* Render the keys left unmapped, which play 12-TET */
+        unmappedKeysLabel.setFont(juce::Font(16.0f, juce::Font::bold));
+        unmappedKeysLabel.setColour(juce::Label::textColourId, colours[inputOutlineTextColor]);
+        unmappedKeysLabel.setJustificationType(juce::Justification::centred);
+        addAndMakeVisible(unmappedKeysLabel);
+        updateUnmappedKeys();
 }
 /*
   * Description: Destructor for stopping audio
@@ -158,7 +170,7 @@ MainContentComponent::~MainContentComponent()
 void MainContentComponent::resized()
 {
         /* Set main window bounds */
-        divisions = (int)microtonalMappings[mappingIndex].divisions;
+        divisions = (int)mapping.divisions;
         auto area = getLocalBounds();
         auto upperWindowArea = area.removeFromTop(getHeight());
         upperWindow.setBounds(upperWindowArea);
@@ -196,23 +208,28 @@ void MainContentComponent::resized()
         int boxHeight = divisionInput.getWidth()*0.70;
         int boxWidth = boxHeight + 5;
         generateFrequencies.setBounds(keyboardWindow.getX() + divisionMargin, keyboardWindow.getY() + 2*frequencyHeight + divisionMargin, (3.0/2)*frequencyWidth, frequencyHeight);
+        spanKeyboardToggle.setBounds(keyboardWindow.getX() + divisionMargin, keyboardWindow.getY() + 3*frequencyHeight + divisionMargin, (3.0/2)*frequencyWidth, frequencyHeight - 2*divisionMargin);
         shortHandBtn.setBounds(((keyboardWindow.getWidth() + 2 * keyboardWindowMargin) + (keyboardComponent.getX() + keyboardComponent.getWidth()))/2 - (3.0 / 4) * frequencyWidth, keyboardWindow.getY() + 2 * frequencyHeight + divisionMargin + 15, (3.0 / 2) * frequencyWidth, frequencyHeight);
         shortHandInput.setBounds(((keyboardWindow.getWidth() + 2 * keyboardWindowMargin) + (keyboardComponent.getX() + keyboardComponent.getWidth())) / 2 - (3.0 / 4) * frequencyWidth, keyboardWindow.getY() + 2 * frequencyHeight + divisionMargin - frequencyHeight/2 + 15, (3.0 / 2) * frequencyWidth, frequencyHeight / 2);
         savePreset.setBounds(((keyboardWindow.getWidth() + 2 * keyboardWindowMargin) + (keyboardComponent.getX() + keyboardComponent.getWidth())) / 2 - (3.0 / 4) * frequencyWidth, keyboardComponent.getY(), (3.0 / 2) * frequencyWidth, frequencyHeight);
+        unmappedKeysLabel.setBounds(savePreset.getX() - frequencyWidth / 2, savePreset.getBottom() + divisionMargin, 2 * frequencyWidth + frequencyWidth / 2, frequencyHeight / 2);
 
-        /* Set bounds for frequency buttons so they are centered */
-        auto iter = 1;
-        vector<double>positions;
-        positions.push_back(keyboardWindow.getWidth() / 2 + boxWidth / 2 - 10);
-        for (int i = 1; i < divisions; i++) {
-            positions.push_back(positions[0] + iter * (i % 2 == 0 ? 1 : -1) * ((boxWidth + 2)));
-            iter = i % 2 == 0 ? iter + 1 : iter;
-        }
-        sort(positions.begin(), positions.end());
+        /* Set bounds for frequency buttons so they are centered, wrapping into rows and shrinking when there are too many for one */
         auto Y = upperWindow.getY() + (keyboardWindow.getHeight() * 2) / 10; //+ (generateFrequencies.getHeight() / 3);
-        for (int i = 0; i < divisions; i++) {
-            frequencyBoxes[i].setBounds(positions[i], Y, boxWidth, boxHeight);
-            frequencyBoxes[i].getBestWidthForHeight(boxHeight);
+        int rowWidth = keyboardWindow.getWidth() - 2 * keyboardWindowMargin;
+        int rowsHeight = juce::jmax(boxHeight, keyboardWindow.getY() - Y - keyboardWindowMargin);
+        int cell = boxWidth + 2;
+        int columns = juce::jmax(1, rowWidth / cell);
+        if (((divisions + columns - 1) / columns) * cell > rowsHeight) {
+            cell = juce::jmax(12, (int)std::sqrt((double)rowWidth * rowsHeight / juce::jmax(1, divisions)));
+            columns = juce::jmax(1, rowWidth / cell);
+        }
+        int boxCount = juce::jmin(divisions, frequencyBoxes.size());
+        for (int i = 0; i < boxCount; i++) {
+            int row = i / columns, column = i % columns;
+            int boxesInRow = juce::jmin(columns, divisions - row * columns);
+            int X = keyboardWindow.getWidth() / 2 + keyboardWindowMargin - (boxesInRow * cell) / 2 + column * cell;
+            frequencyBoxes[i]->setBounds(X, Y + row * cell, cell - 2, juce::jmin(boxHeight, cell - 2));
         }
 
         /* Set bounds for buttons above the keys so they are aligned */
@@ -255,18 +272,19 @@ float MainContentComponent::roundoff(float value, unsigned char prec)
 */
 void MainContentComponent::paint(juce::Graphics& g) {
     /* Changes the color of the frequency boxes and draws a line connecting them to the keyboard keys */
-    for (int i = 0; i < frequencies.size(); i++) {
+    int boxCount = juce::jmin((int)frequencies.size(), frequencyBoxes.size());
+    for (int i = 0; i < boxCount; i++) {
         for (int j = 0; j < 12; j++) {
-            if (roundoff(frequencies[i], 1) == roundoff(microtonalMappings[mappingIndex].frequencies[j].frequency, 1)) {
-                float startX = frequencyBoxes[i].getX() + (frequencyBoxes[i].getWidth() / 2),
-                    startY = frequencyBoxes[i].getY() + frequencyBoxes[i].getHeight(),
+            if (roundoff(frequencies[i], 1) == roundoff(mapping.frequencies[j].frequency, 1)) {
+                float startX = frequencyBoxes[i]->getX() + (frequencyBoxes[i]->getWidth() / 2),
+                    startY = frequencyBoxes[i]->getY() + frequencyBoxes[i]->getHeight(),
                     endX = noteButtons[j].getX() + (noteButtons[j].getWidth() / 2),
                     endY = noteButtons[j].getY();
 
                 juce::Line<float> line(juce::Point<float>(startX,startY), juce::Point<float>(endX,endY));
                 g.setColour(freqColors[j]);
                 g.drawLine(line, 3.0f);
-                frequencyBoxes[i].setColour(juce::TextButton::buttonColourId, freqColors[j]);
+                frequencyBoxes[i]->setColour(juce::TextButton::buttonColourId, freqColors[j]);
             }
         }
     }
@@ -298,9 +316,9 @@ void MainContentComponent::releaseResources()
 */
 void MainContentComponent::undoButtonHighlighting()
 {
-    for (auto& b : frequencyBoxes) {
-        b.removeColour(juce::ComboBox::outlineColourId);
-        b.setColour(juce::TextButton::buttonColourId, juce::Colours::white);
+    for (auto* b : frequencyBoxes) {
+        b->removeColour(juce::ComboBox::outlineColourId);
+        b->setColour(juce::TextButton::buttonColourId, juce::Colours::white);
     }
 }
 
@@ -312,12 +330,13 @@ void MainContentComponent::undoButtonHighlighting()
 */
 void MainContentComponent::buttonClicked(juce::Button* btn)
 {
-    for (int i = 0; i < 24; i++) {
+    for (int i = 0; i < juce::jmax(frequencyBoxes.size(), 12); i++) {
         /* Generate frequencies button */
         if (btn == &generateFrequencies) {
+            clearImportedTuning();
             for (int i = 0; i < 12; i++) {
-                microtonalMappings[mappingIndex].frequencies[i].frequency = NULL;
-                microtonalMappings[mappingIndex].frequencies[i].index = NULL;
+                mapping.frequencies[i].frequency = NULL;
+                mapping.frequencies[i].index = NULL;
             }
             genFreqFunc(); 
             this->resized();
@@ -325,37 +344,39 @@ void MainContentComponent::buttonClicked(juce::Button* btn)
         }
 
         /* A frequency box has been selected */
-        else if (btn == &frequencyBoxes[i]) {
+        else if (btn == frequencyBoxes[i]) {
             if (freqBoxIndex != i) { 
                 freqBoxIndex = i; undoButtonHighlighting(); 
-                frequencyBoxes[i].setColour(juce::TextButton::buttonColourId, juce::Colours::yellow);
-                frequencyBoxes[i].setColour(juce::ComboBox::outlineColourId, juce::Colours::black); 
+                frequencyBoxes[i]->setColour(juce::TextButton::buttonColourId, juce::Colours::yellow);
+                frequencyBoxes[i]->setColour(juce::ComboBox::outlineColourId, juce::Colours::black); 
                 return; 
             }
 
         }
 
         /* A note button has been clicked to map to the previously selected frequency box */
-        else if (btn == &noteButtons[i]) {
+        else if (i < 12 && btn == &noteButtons[i]) {
             if (freqBoxIndex == -1) return;
-            if (microtonalMappings[mappingIndex].frequencies[i].frequency != NULL) {
+            if (mapping.frequencies[i].frequency != NULL) {
                 for (int j = 0; j < frequencies.size(); j++) {
-                    if (frequencies[j] == microtonalMappings[mappingIndex].frequencies[i].frequency) {
-                        frequencyBoxes[j].setColour(juce::TextButton::buttonColourId, juce::Colours::white);
+                    if (frequencies[j] == mapping.frequencies[i].frequency) {
+                        frequencyBoxes[j]->setColour(juce::TextButton::buttonColourId, juce::Colours::white);
                     }
                 }
             }
-            microtonalMappings[mappingIndex].frequencies[i].index = freqBoxIndex;
-            microtonalMappings[mappingIndex].frequencies[i].frequency = frequencies[freqBoxIndex];
+            clearImportedTuning();
+            mapping.frequencies[i].index = freqBoxIndex;
+            mapping.frequencies[i].frequency = frequencies[freqBoxIndex];
             for (int k = 0; k < 12; k++) {
                 if (k == i) continue;
                 
-                if (microtonalMappings[mappingIndex].frequencies[k].frequency == microtonalMappings[mappingIndex].frequencies[i].frequency) microtonalMappings[mappingIndex].frequencies[k].frequency = NULL;
+                if (mapping.frequencies[k].frequency == mapping.frequencies[i].frequency) mapping.frequencies[k].frequency = NULL;
             }
             noteButtons[i].setColour(juce::TextButton::buttonColourId, freqColors[i]);
-            frequencyBoxes[freqBoxIndex].setColour(juce::TextButton::buttonColourId, freqColors[i]);
-            frequencyBoxes[freqBoxIndex].removeColour(juce::ComboBox::outlineColourId);
+            frequencyBoxes[freqBoxIndex]->setColour(juce::TextButton::buttonColourId, freqColors[i]);
+            frequencyBoxes[freqBoxIndex]->removeColour(juce::ComboBox::outlineColourId);
             freqBoxIndex = -1;
+            updateUnmappedKeys();
             repaint();
             return;
         }
@@ -389,7 +410,7 @@ void MainContentComponent::buttonClicked(juce::Button* btn)
 */
 void MainContentComponent::mappingShortcut(string inputString) {
     if (inputString == "") return;
-    if (!regex_match(inputString, regex("^\\s*\\d\\d?\\s+\\d\\d?\\s+\\d\\d?\\s*$"))) return;
+    if (!regex_match(inputString, regex("^\\s*\\d{1,4}\\s+\\d{1,4}\\s+\\d{1,4}\\s*$"))) return;
     istringstream iss(inputString);
 
     string word;
@@ -409,9 +430,10 @@ void MainContentComponent::mappingShortcut(string inputString) {
     genFreqFunc();
 
     /* Clear mapping */
+    clearImportedTuning();
     for (int i = 0; i < 12; i++) {
-        microtonalMappings[mappingIndex].frequencies[i].index = NULL;
-        microtonalMappings[mappingIndex].frequencies[i].frequency = NULL;
+        mapping.frequencies[i].index = NULL;
+        mapping.frequencies[i].frequency = NULL;
     }
 
     /* Edge case for if steps is equal to 1, previously caused errors */
@@ -419,9 +441,9 @@ void MainContentComponent::mappingShortcut(string inputString) {
         start = 0; finish = 11;
 
         for (int i = start; i <= finish; i += steps) {
-            if (i >= microtonalMappings[mappingIndex].divisions) break;
-            microtonalMappings[mappingIndex].frequencies[noteBlock].index = noteBlock;
-            microtonalMappings[mappingIndex].frequencies[noteBlock].frequency = frequencies[i];
+            if (i >= mapping.divisions) break;
+            mapping.frequencies[noteBlock].index = noteBlock;
+            mapping.frequencies[noteBlock].frequency = frequencies[i];
             noteBlock++;
         }
     }
@@ -429,13 +451,14 @@ void MainContentComponent::mappingShortcut(string inputString) {
     /* Map frequencies based on input string */
     else {
         for (int i = start; i <= finish; i += steps, noteBlock++) {
-            if (i >= microtonalMappings[mappingIndex].divisions) break;
-            microtonalMappings[mappingIndex].frequencies[noteBlock].index = noteBlock;
-            microtonalMappings[mappingIndex].frequencies[noteBlock].frequency = frequencies[i];
+            if (i >= mapping.divisions) break;
+            mapping.frequencies[noteBlock].index = noteBlock;
+            mapping.frequencies[noteBlock].frequency = frequencies[i];
         }
     }
 
     /* Add color and connecting lines to new mapping */
+    updateUnmappedKeys();
     repaint();
 }
 
@@ -447,17 +470,20 @@ void MainContentComponent::mappingShortcut(string inputString) {
 */
 void MainContentComponent::genFreqFunc() {
     /* Store mapping variables */
-    microtonalMappings[mappingIndex].divisions = divisionInput.getText().getDoubleValue();
-    microtonalMappings[mappingIndex].base_frequency = baseFreqInput.getText().getDoubleValue();
-    frequencies = microtonalMappings[mappingIndex].getAllFrequencies();
-
-    /* Render frequency boxes */
-    for (int i = 0; i < microtonalMappings[mappingIndex].divisions; i++) {
-        frequencyBoxes[i].setButtonText(to_string(frequencies[i]).substr(0, 5));
-        frequencyBoxes[i].setColour(juce::TextButton::buttonColourId, juce::Colours::white);
-        frequencyBoxes[i].setColour(juce::TextButton::textColourOffId, juce::Colours::black);
-        frequencyBoxes[i].addListener(this);
-        frequencyBoxes[i].setMouseCursor(juce::MouseCursor::PointingHandCursor);
+    mapping.divisions = divisionInput.getText().getDoubleValue();
+    mapping.base_frequency = baseFreqInput.getText().getDoubleValue();
+    frequencies = mapping.getAllFrequencies();
+
+    /* Render frequency boxes, adding more if the divisions outgrew them */
+    while (frequencyBoxes.size() < mapping.divisions)
+        frequencyBoxes.add(new juce::TextButton());
+
+    for (int i = 0; i < mapping.divisions; i++) {
+        frequencyBoxes[i]->setButtonText(to_string(frequencies[i]).substr(0, 5));
+        frequencyBoxes[i]->setColour(juce::TextButton::buttonColourId, juce::Colours::white);
+        frequencyBoxes[i]->setColour(juce::TextButton::textColourOffId, juce::Colours::black);
+        frequencyBoxes[i]->addListener(this);
+        frequencyBoxes[i]->setMouseCursor(juce::MouseCursor::PointingHandCursor);
         addAndMakeVisible(frequencyBoxes[i]);
     } 
 
@@ -468,16 +494,17 @@ void MainContentComponent::genFreqFunc() {
         noteButtons[i].addListener(this);
     }
     /* Deactivate and remove frequency buttons that are higher indices than the selected total divisions */
-    for (int i = microtonalMappings[mappingIndex].divisions; i < 24; i++) {
+    for (int i = mapping.divisions; i < frequencyBoxes.size(); i++) {
         try{ 
-            frequencyBoxes[i].setMouseCursor(juce::MouseCursor::NormalCursor);
-            frequencyBoxes[i].setVisible(false); 
-            frequencyBoxes[i].removeListener(this);
+            frequencyBoxes[i]->setMouseCursor(juce::MouseCursor::NormalCursor);
+            frequencyBoxes[i]->setVisible(false); 
+            frequencyBoxes[i]->removeListener(this);
         }
         catch (const std::exception&){}
     }
 
     /* Add/remove color and connecting lines from frequency boxes */
+    updateUnmappedKeys();
     repaint();
 }
 
@@ -491,7 +518,7 @@ void MainContentComponent::genFreqFunc() {
 string MainContentComponent::writeValuesToXML() {
     ofstream outf{ "../../Configs/previousState.xml" };
     if (!outf) { return "Error loading config."; }
-    // juce::String writeToXML = microtonalMappings[mappingIndex].generateXML().toString();
+    // juce::String writeToXML = mapping.generateXML().toString();
     // outf << writeToXML;
     return NULL;
 }
@@ -504,7 +531,7 @@ string MainContentComponent::writeValuesToXML() {
 */
 bool MainContentComponent::validateDivisionInput(const juce::String& s)
 {
-    return s.containsOnly("0123456789") && s.getIntValue() >= 12 && s.getIntValue() <= 24;
+    return s.containsOnly("0123456789") && s.getIntValue() >= 1 && s.getIntValue() <= MicrotonalConfig::maxDivisions;
 }
 
 /*
@@ -530,6 +557,44 @@ void MainContentComponent::timerCallback()
     stopTimer();
 }
 
+/*
+  * Description: Drops a Scala tuning imported into this preset, so the edited mapping is what plays
+  * Is generated by JUCE: No
+  * Parameters: None
+  * Return: N/A
+*/
+void MainContentComponent::clearImportedTuning()
+{
+    context.importedTunings[index].reset();
+}
+
+/*
+  * Description: Compiles the mapping as the synth would, for the keyboard to play, and lists the pitch classes it leaves without a frequency
+  * Is generated by JUCE: No
+  * Parameters: None
+  * Return: N/A
+*/
+void MainContentComponent::updateUnmappedKeys()
+{
+    previewTable.compile(mapping, 44100.0);
+    if (previewTable.isFullyMapped()) {
+        unmappedKeysLabel.setText("All keys mapped", juce::dontSendNotification);
+        return;
+    }
+
+    const auto& unmapped = previewTable.getUnmappedKeys();
+    juce::StringArray names;
+    for (int pitchClass = 0; pitchClass < 12; pitchClass++) {
+        for (int key = pitchClass; key < TuningTable::numKeys; key += 12) {
+            if (unmapped[(size_t)key]) {
+                names.add(juce::MidiMessage::getMidiNoteName(pitchClass, true, false, 4));
+                break;
+            }
+        }
+    }
+    unmappedKeysLabel.setText("Unmapped (12-TET): " + names.joinIntoString(", "), juce::dontSendNotification);
+}
+
 /*
   * Description: Used for saving a microtonal preset to a file
   * Is generated by JUCE: No
@@ -542,15 +607,15 @@ void MainContentComponent::saveMicrotonalPreset(int preset) {
     auto flags = juce::FileBrowserComponent::saveMode
         | juce::FileBrowserComponent::canSelectFiles
         | juce::FileBrowserComponent::warnAboutOverwriting;
-    juce::String mapping = microtonalMappings[preset].generateValueTree().toXmlString();
-    chooser->launchAsync(flags, [this, mapping, preset](const juce::FileChooser& fc) {
+    juce::String mappingXml = context.microtonalMappings[preset].generateValueTree().toXmlString();
+    chooser->launchAsync(flags, [this, mappingXml, preset](const juce::FileChooser& fc) {
         if (fc.getResult() == juce::File{})
             return;
         juce::File myFile = fc.getResult().withFileExtension("xml");
         juce::String fileName = myFile.getFileName();
-        microtonalPresetNames[preset] = fileName;
+        context.microtonalPresetNames[preset] = fileName;
         /* Save file logic goes here*/
-        if (!myFile.replaceWithText(mapping)) {
+        if (!myFile.replaceWithText(mappingXml)) {
             juce::AlertWindow::showMessageBoxAsync(
                 juce::AlertWindow::WarningIcon,
                 TRANS("Error whilst saving"),
@@ -564,10 +629,10 @@ void MainContentComponent::saveMicrotonalPreset(int preset) {
   * Description: Methods for keyboard sound generation
   * Is generated by JUCE: Yes
 */
-SynthAudioSource::SynthAudioSource(juce::MidiKeyboardState& keyState): keyboardState(keyState)
+SynthAudioSource::SynthAudioSource(juce::MidiKeyboardState& keyState, const TuningTable& tuning): keyboardState(keyState)
 {
     for (auto i = 0; i < 4; ++i)                
-        synth.addVoice(new SineWaveVoice());
+        synth.addVoice(new SineWaveVoice(tuning));
 
     synth.addSound(new SineWaveSound());       
 }
@@ -15,11 +15,10 @@
 #include <cctype> 
 #include <atomic>
 #include "Microtonal.h"
+#include "../../audioProcessor/engineContext.h"
+#include "../../audioProcessor/tuningTable.h"
 using namespace std;
 
-//==============================================================================
-extern MicrotonalConfig microtonalMappings[7];
-extern atomic<int> mappingIndex;
 //=================================================================================================
 struct SineWaveSound : public juce::SynthesiserSound
 {
@@ -37,7 +36,7 @@ struct SineWaveSound : public juce::SynthesiserSound
 */
 struct SineWaveVoice : public juce::SynthesiserVoice
 {
-    SineWaveVoice() {}
+    SineWaveVoice(const TuningTable& tuningToPlay) : tuning(tuningToPlay) {}
 
     bool canPlaySound(juce::SynthesiserSound* sound) override
     {
@@ -51,10 +50,8 @@ struct SineWaveVoice : public juce::SynthesiserVoice
         level = velocity * 0.15;
         tailOff = 0.0;
 
-        // auto cyclesPerSecond = juce::MidiMessage::getMidiNoteInHertz (midiNoteNumber);
-        double cyclesPerSecond;
-        if (microtonalMappings[mappingIndex].frequencies[midiNoteNumber - 72].frequency == NULL) cyclesPerSecond = 440.0 * std::pow(2.0, (midiNoteNumber - 81) / 12.0); 
-        else  cyclesPerSecond = microtonalMappings[mappingIndex].frequencies[midiNoteNumber - 72].frequency;
+        // the mapping as the synth compiles it, with unmapped keys on 12-TET
+        auto cyclesPerSecond = tuning.getKey(midiNoteNumber).frequency;
 
         auto cyclesPerSample = cyclesPerSecond / getSampleRate();
 
@@ -146,12 +143,13 @@ struct SineWaveVoice : public juce::SynthesiserVoice
     }
 
 private:
+    const TuningTable& tuning;
     double currentAngle = 0.0, angleDelta = 0.0, level = 0.0, tailOff = 0.0;
 };
 class SynthAudioSource : public juce::AudioSource
 {
 public:
-    SynthAudioSource(juce::MidiKeyboardState& keyState);
+    SynthAudioSource(juce::MidiKeyboardState& keyState, const TuningTable& tuning);
 
     void setUsingSineWaveSound();
 
@@ -172,7 +170,7 @@ class MainContentComponent : public juce::AudioAppComponent,
     public juce::Button::Listener
 {
 public:
-    MainContentComponent(int index);
+    MainContentComponent(EngineContext& context, int index);
 
     ~MainContentComponent() override;
 
@@ -220,11 +218,16 @@ private:
 
     void timerCallback() override;
     void saveMicrotonalPreset(int preset);
+    void clearImportedTuning();
+    void updateUnmappedKeys();
     
+    EngineContext& context;
+    MicrotonalConfig& mapping;  // the preset this window edits, context.microtonalMappings[index]
     int test = 1;
     int divisions; 
     double frequency = 440.0;
     juce::MidiKeyboardState keyboardState;
+    TuningTable previewTable;  // the mapping as the synth compiles it, for the keyboard and its unmapped keys
     SynthAudioSource synthAudioSource;
 
     juce::MidiKeyboardComponent keyboardComponent;
@@ -237,6 +240,7 @@ private:
     juce::Label baseFreqInput;
     juce::Label divisionInput;
     juce::Label shortHandInput;
+    juce::Label unmappedKeysLabel;
     int freqBoxIndex = -1, selectedFrequencyIndex = 0;
     vector<double> frequencies;
 
@@ -259,11 +263,12 @@ private:
     juce::TextButton saveToXMLBtn;
     juce::TextButton shortHandBtn;
     juce::TextButton savePreset;
+    juce::ToggleButton spanKeyboardToggle;
     std::unique_ptr<juce::FileChooser> chooser;
     int index;
 
     int startKey = 72;
-    juce::TextButton frequencyBoxes[24];
+    juce::OwnedArray<juce::TextButton> frequencyBoxes;  // grows to the largest division count used, never shrinks
     juce::TextButton noteButtons[12];
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainContentComponent)